@@ -9,6 +9,10 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <poll.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
 
 #include <linux/types.h>
 #include <libnl3/netlink/socket.h>
@@ -56,6 +60,13 @@ typedef struct {
 	char serviceName[MAX_NL_SERVICE_NAME_LEN];
 }nlService_t;
 
+static bool isAbstractClientSocket = false;  /* bind the wpa_ctrl client sockets in the abstract namespace */
+
+/* wpa_ctrl_open2() names the client sockets by a non-atomic counter, and unlinks a clashing name; interfaces may be attached in parallel */
+static pthread_mutex_t wpaCtrlOpenMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *hostapSocketDirs[] = { "/var/run/hostapd/", "/var/run/wpa_supplicant/" };  /* AP first, same as the attach */
+
 nlService_t gNlServices[] = { { NL_SERVICE_VENDOR, "vendor"} ,
                             { NL_SERVICE_SCAN, "scan" }
                             }; // Add more service as in when required
@@ -72,6 +83,11 @@ typedef struct
 			struct wpa_ctrl *wpaCtrlPtr;
 			struct wpa_ctrl *listenerWpaCtrlPtr;   /*needed when closing it*/
 			int    fd;
+			unsigned int cmdTimeoutMs;  /* default deadline of a command round trip */
+			bool   isStaleReplyPossible;  /* a previous command was abandoned; its reply may still arrive */
+			bool   isPingPending;  /* a PING was sent via dwpal_hostap_ping_send, and its PONG was not received yet */
+			bool   isLevelReplyPending;  /* one-way: a LEVEL was sent via dwpal_hostap_event_level_set, and its reply was not received yet */
+			struct timespec pingSendTime, lastEventTime, lastReplyTime;  /* CLOCK_MONOTONIC */
 			DWPAL_wpaCtrlEventCallback wpaCtrlEventCallback;  /* callback function for hostapd received events while command is being sent; can be NULL */
 		} hostapd;
 
@@ -2359,6 +2375,274 @@ DWPAL_Ret dwpal_string_to_struct_parse(char *msg, size_t msgLen, FieldsToParse f
 }
 
 
+/* Returns the number of msec left till 'deadline' (0 if already passed) */
+static int msecRemainingGet(struct timespec *deadline)
+{
+	struct timespec now;
+	long long       msec;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	msec = (long long)(deadline->tv_sec - now.tv_sec) * 1000 + (deadline->tv_nsec - now.tv_nsec) / 1000000;
+
+	return (msec > 0) ? (int)msec : 0;
+}
+
+
+/* Returns the number of msec passed since 'since' */
+static unsigned int msecElapsedGet(struct timespec *since)
+{
+	struct timespec now;
+	long long       msec;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	msec = (long long)(now.tv_sec - since->tv_sec) * 1000 + (now.tv_nsec - since->tv_nsec) / 1000000;
+
+	return (msec > 0) ? (unsigned int)msec : 0;
+}
+
+
+/* In case that 'msg' is the reply of a PING sent via dwpal_hostap_ping_send, record it, and return true */
+static bool isPongReceived(DWPAL_Context *localContext, const char *msg, size_t msgLen)
+{
+	if ( (localContext == NULL) || (!localContext->interface.hostapd.isPingPending) || (msgLen != 5) || (strncmp(msg, "PONG\n", 5)) )
+	{
+		return false;
+	}
+
+	localContext->interface.hostapd.isPingPending = false;
+	clock_gettime(CLOCK_MONOTONIC, &localContext->interface.hostapd.lastEventTime);
+
+	return true;
+}
+
+
+/* In case that 'msg' is the reply of a LEVEL sent via dwpal_hostap_event_level_set on the event socket, consume it, and return true */
+static bool isLevelReplyReceived(DWPAL_Context *localContext, const char *msg, size_t msgLen)
+{
+	if ( (!localContext->interface.hostapd.isLevelReplyPending) || (msgLen == 0) || (msg[0] == '<') )
+	{
+		return false;
+	}
+
+	localContext->interface.hostapd.isLevelReplyPending = false;
+
+	if (strncmp(msg, "OK", 2))
+	{  /* i.e. "UNKNOWN COMMAND" of an old hostapd */
+		console_printf("%s; LEVEL is not supported (VAPName= '%s') ==> events are not filtered by hostapd\n", __FUNCTION__, localContext->interface.hostapd.VAPName);
+	}
+
+	return true;
+}
+
+
+/* Discard the replies pending in the socket; zero-length receive drops a datagram without copying it.
+ * On a two-way socket, the pending events are delivered to 'msgCallback' rather than discarded,
+ * and the PONG of a pending PING (sent on the same socket) is recorded into 'pongContext' */
+static void staleRepliesDrain(int fd, DWPAL_wpaCtrlEventCallback msgCallback, DWPAL_Context *pongContext)
+{
+	ssize_t res;
+	char    *msg;
+
+	while (true)
+	{
+		if ((res = recv(fd, NULL, 0, MSG_PEEK | MSG_TRUNC | MSG_DONTWAIT)) < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			break;  /* EAGAIN: nothing is left */
+		}
+
+		if ( (res == 0) || (msgCallback == NULL) || ((msg = (char *)malloc((size_t)res + 1)) == NULL) )
+		{
+			recv(fd, NULL, 0, MSG_DONTWAIT);
+			console_printf("%s; stale reply (len= %d) discarded\n", __FUNCTION__, (int)res);
+			continue;
+		}
+
+		res = recv(fd, msg, (size_t)res, MSG_DONTWAIT);
+		if ( (res > 0) && (msg[0] == '<') )
+		{
+			msg[res] = '\0';
+			msgCallback(msg, (size_t)res);
+		}
+		else if ( (res > 0) && (isPongReceived(pongContext, msg, (size_t)res)) )
+		{
+			//console_printf("%s; PONG received\n", __FUNCTION__);
+		}
+		else
+		{
+			console_printf("%s; stale reply (len= %d) discarded\n", __FUNCTION__, (int)res);
+		}
+
+		free((void *)msg);
+	}
+}
+
+
+/* Same as wpa_ctrl_request(), but bounded by 'timeoutMs', and retries of a congested socket are driven by POLLOUT instead of sleeps.
+ * In case of 'isReplyAlloc', each datagram is sized before it is received, and the reply is received complete into a right-sized
+ * buffer (allocated here, freed by the caller); otherwise, a reply longer than '*replyLen' is truncated.
+ * The PONG of a PING sent via dwpal_hostap_ping_send on the same (two-way) socket is recorded into 'pongContext', and is not taken as the reply */
+static DWPAL_Ret hostapdRequest(struct wpa_ctrl *wpaCtrlPtr, const char *cmd, size_t cmdLen, char **reply /*IN/OUT*/, size_t *replyLen /*IN/OUT*/,
+                                bool isReplyAlloc, DWPAL_wpaCtrlEventCallback msgCallback, DWPAL_Context *pongContext, unsigned int timeoutMs)
+{
+	int             fd = wpa_ctrl_get_fd(wpaCtrlPtr);
+	ssize_t         res;
+	char            *buf = isReplyAlloc ? NULL : *reply;
+	size_t          bufLen = isReplyAlloc ? 0 : *replyLen;
+	DWPAL_Ret       ret = DWPAL_FAILURE;
+	struct pollfd   pfd;
+	struct timespec deadline;
+
+	clock_gettime(CLOCK_MONOTONIC, &deadline);
+	deadline.tv_sec += timeoutMs / 1000;
+	deadline.tv_nsec += (long)(timeoutMs % 1000) * 1000000L;
+	if (deadline.tv_nsec >= 1000000000L)
+	{
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000L;
+	}
+
+	pfd.fd = fd;
+
+	while ((res = send(fd, cmd, cmdLen, MSG_DONTWAIT)) < 0)
+	{
+		if ( (errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != ENOBUFS) && (errno != EINTR) )
+		{
+			console_printf("%s; send() fail; errno= %d ('%s') ==> Abort!\n", __FUNCTION__, errno, strerror(errno));
+			return DWPAL_FAILURE;
+		}
+
+		/* hostapd is not reading its socket fast enough; wait till there is room, or the deadline passed */
+		pfd.events = POLLOUT;
+		res = poll(&pfd, 1, msecRemainingGet(&deadline));
+		if (res == 0)
+		{
+			console_printf("%s; send timed out ==> Abort!\n", __FUNCTION__);
+			return DWPAL_TIMEOUT;
+		}
+
+		if ( (res < 0) && (errno != EINTR) && (errno != EAGAIN) )
+		{
+			console_printf("%s; poll() fail; errno= %d ('%s') ==> Abort!\n", __FUNCTION__, errno, strerror(errno));
+			return DWPAL_FAILURE;
+		}
+	}
+
+	while (true)
+	{
+		pfd.events = POLLIN;
+		res = poll(&pfd, 1, msecRemainingGet(&deadline));
+		if (res < 0)
+		{
+			if ( (errno == EINTR) || (errno == EAGAIN) )
+			{
+				continue;
+			}
+
+			console_printf("%s; poll() fail; errno= %d ('%s') ==> Abort!\n", __FUNCTION__, errno, strerror(errno));
+			break;
+		}
+
+		if (res == 0)
+		{
+			console_printf("%s; reply timed out (timeoutMs= %u) ==> Abort!\n", __FUNCTION__, timeoutMs);
+			ret = DWPAL_TIMEOUT;
+			break;
+		}
+
+		if (isReplyAlloc)
+		{
+			/* Size the pending datagram, and make room for it (and for the terminating NULL) */
+			res = recv(fd, NULL, 0, MSG_PEEK | MSG_TRUNC | MSG_DONTWAIT);
+			if (res < 0)
+			{
+				if ( (errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR) )
+				{
+					continue;
+				}
+
+				console_printf("%s; recv() (peek) fail; errno= %d ('%s') ==> Abort!\n", __FUNCTION__, errno, strerror(errno));
+				break;
+			}
+
+			if (res == 0)
+			{  /* there is no reply to size the buffer by; the empty datagram is discarded */
+				recv(fd, NULL, 0, MSG_DONTWAIT);
+				console_printf("%s; empty reply ==> Abort!\n", __FUNCTION__);
+				break;
+			}
+
+			if ((size_t)res + 1 > bufLen)
+			{
+				char *newBuf = (char *)realloc(buf, (size_t)res + 1);
+
+				if (newBuf == NULL)
+				{
+					console_printf("%s; realloc (%d bytes) failed ==> Abort!\n", __FUNCTION__, (int)res + 1);
+					break;
+				}
+
+				buf = newBuf;
+				bufLen = (size_t)res + 1;
+			}
+		}
+
+		res = recv(fd, buf, isReplyAlloc ? bufLen - 1 : bufLen, MSG_TRUNC | MSG_DONTWAIT);
+		if (res < 0)
+		{
+			if ( (errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR) )
+			{
+				continue;
+			}
+
+			console_printf("%s; recv() fail; errno= %d ('%s') ==> Abort!\n", __FUNCTION__, errno, strerror(errno));
+			break;
+		}
+
+		if (!isReplyAlloc && ((size_t)res > bufLen))
+		{
+			console_printf("%s; reply truncated (%d bytes, buffer is %d bytes)\n", __FUNCTION__, (int)res, (int)bufLen);
+			res = (ssize_t)bufLen;
+		}
+
+		if ( (res > 0) && (buf[0] == '<') )
+		{  /* This is an unsolicited event, and not the reply */
+			if (msgCallback != NULL)
+			{
+				if ((size_t)res == bufLen)
+				{
+					res = (ssize_t)(bufLen - 1);
+				}
+				buf[res] = '\0';
+				msgCallback(buf, (size_t)res);
+			}
+			continue;
+		}
+
+		if (isPongReceived(pongContext, buf, (size_t)res))
+		{
+			continue;
+		}
+
+		*reply = buf;
+		*replyLen = (size_t)res;
+		return DWPAL_SUCCESS;
+	}
+
+	if (isReplyAlloc)
+	{
+		free((void *)buf);
+	}
+
+	return ret;
+}
+
+
 /**************************************************************************/
 /*! \fn DWPAL_Ret dwpal_hostap_cmd_send(void *context, const char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char *reply, size_t *replyLen)
  **************************************************************************
@@ -2368,19 +2652,24 @@ DWPAL_Ret dwpal_string_to_struct_parse(char *msg, size_t msgLen, FieldsToParse f
  *  \param[in] FieldsToCmdParse *fieldsToCmdParse - The command parsing information, in which accordingly, the command string (after the header) will be created
  *  \param[out] char *reply - The output string returning from the hostap command
  *  \param[in,out] size_t *replyLen - Provide the max output string length, and get back the actual string length
- *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, DWPAL_TIMEOUT if no reply within the context's deadline, other for failure)
  ***************************************************************************/
 DWPAL_Ret dwpal_hostap_cmd_send(void *context, const char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char *reply /*OUT*/, size_t *replyLen /*IN/OUT*/)
+{
+	return dwpal_hostap_cmd_send_timeout(context, cmdHeader, fieldsToCmdParse, reply, replyLen, 0 /*use the context's deadline*/);
+}
+
+
+static DWPAL_Ret hostapCmdSend(void *context, const char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char **reply /*IN/OUT*/, size_t *replyLen /*IN/OUT*/, bool isReplyAlloc, unsigned int timeoutMs)
 {
 	int  i;
 	int  ret;
 	char cmd[DWPAL_TO_HOSTAPD_MSG_LENGTH];
 	DWPAL_Context *localContext = (DWPAL_Context *)context;
 
-	if ( (localContext == NULL) || (cmdHeader == NULL) || (reply == NULL) || (replyLen == NULL) )
+	if (timeoutMs == 0)
 	{
-		console_printf("%s; input params error ==> Abort!\n", __FUNCTION__);
-		return DWPAL_FAILURE;
+		timeoutMs = localContext->interface.hostapd.cmdTimeoutMs;
 	}
 
 	if (localContext->interface.hostapd.wpaCtrlPtr == NULL)
@@ -2468,55 +2757,41 @@ DWPAL_Ret dwpal_hostap_cmd_send(void *context, const char *cmdHeader, FieldsToCm
 
 	//console_printf("%s; cmd= '%s'\n", __FUNCTION__, cmd);
 
-	memset((void *)reply, '\0', *replyLen);  /* Clear the output buffer */
-
-	if (localContext->interface.hostapd.wpaCtrlEventCallback == NULL)
+	if (!isReplyAlloc)
 	{
-		/* non-valid wpaCtrlEventCallback states that this is a one-way connection */
-		while (wpa_ctrl_pending(localContext->interface.hostapd.wpaCtrlPtr))
-		{
-			/* clear this message still stuck in the socket, probably becuase hostapd
-			 * took too long to answer a previous request made by us.
-			 * if not cleared, this message will be the response for this wpa_ctrl_request call */
-			size_t buffLen = HOSTAPD_TO_DWPAL_MSG_LENGTH * sizeof(char);
-			char *buff = (char *)malloc((size_t)buffLen);
-
-			console_printf("%s; socket has pending messages\n", __FUNCTION__);
-
-			if (buff == NULL)
-			{
-				console_printf("%s; malloc Failed ==> Abort!\n", __FUNCTION__);
-				return DWPAL_FAILURE;
-			}
+		(*reply)[0] = '\0';  /* Only the received reply is written, and then NULL terminated */
+	}
 
-			memset((void *)buff, '\0', buffLen);
-			buffLen -= 1 * sizeof(char);
-			ret = wpa_ctrl_recv(localContext->interface.hostapd.wpaCtrlPtr,
-					    buff, &buffLen);
-			free((void *)buff);
-			if (ret < 0)
-			{
-				console_printf("%s; wpa_ctrl_recv() returned ERROR ==> Abort!\n", __FUNCTION__);
-				return DWPAL_FAILURE;
-			}
-		}
+	if (localContext->interface.hostapd.isStaleReplyPossible)
+	{
+		/* A late reply of an abandoned command may be pending; if not cleared, it will be taken as the response of this command.
+		 * In one-way connection (non-valid wpaCtrlEventCallback), the command socket receives replies only; in two-way connection,
+		 * the events pending with it are delivered via wpaCtrlEventCallback */
+		staleRepliesDrain(wpa_ctrl_get_fd(localContext->interface.hostapd.wpaCtrlPtr), localContext->interface.hostapd.wpaCtrlEventCallback,
+		                  (localContext->interface.hostapd.wpaCtrlEventCallback != NULL) ? localContext : NULL /*two-way only*/);
+		localContext->interface.hostapd.isStaleReplyPossible = false;
 	}
 
-	ret = wpa_ctrl_request(localContext->interface.hostapd.wpaCtrlPtr,
-	                       cmd,
-						   strnlen_s(cmd, DWPAL_TO_HOSTAPD_MSG_LENGTH),
-						   reply,
-						   replyLen /* should be msg-len in/out param */,
-						   localContext->interface.hostapd.wpaCtrlEventCallback);
-	if (ret < 0)
+	ret = hostapdRequest(localContext->interface.hostapd.wpaCtrlPtr,
+	                     cmd,
+	                     strnlen_s(cmd, DWPAL_TO_HOSTAPD_MSG_LENGTH),
+	                     reply,
+	                     replyLen /* should be msg-len in/out param */,
+	                     isReplyAlloc,
+	                     localContext->interface.hostapd.wpaCtrlEventCallback,
+	                     (localContext->interface.hostapd.wpaCtrlEventCallback != NULL) ? localContext : NULL /*PINGs are sent on the event socket*/,
+	                     timeoutMs);
+	if (ret != DWPAL_SUCCESS)
 	{
-		console_printf("%s; wpa_ctrl_request() returned error; VAPName= '%s' (ret= %d) ==> Abort!\n", __FUNCTION__, localContext->interface.hostapd.VAPName, ret);
+		console_printf("%s; hostapdRequest() returned error; VAPName= '%s' (ret= %d) ==> Abort!\n", __FUNCTION__, localContext->interface.hostapd.VAPName, ret);
+		localContext->interface.hostapd.isStaleReplyPossible = true;
 		*replyLen = 0;
-		return DWPAL_FAILURE;
+		return (DWPAL_Ret)ret;
 	}
-	reply[*replyLen] = '\0';  /* we need it to clear the "junk" at the end of the string */
+	(*reply)[*replyLen] = '\0';  /* we need it to clear the "junk" at the end of the string */
+	clock_gettime(CLOCK_MONOTONIC, &localContext->interface.hostapd.lastReplyTime);
 
-	if (reply[0] == '\0')
+	if ((*reply)[0] == '\0')
 	{  /* The 'reply' string is empty */
 		*replyLen = 0;
 	}
@@ -2526,19 +2801,96 @@ DWPAL_Ret dwpal_hostap_cmd_send(void *context, const char *cmdHeader, FieldsToCm
 }
 
 
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_hostap_cmd_send_timeout(void *context, const char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char *reply, size_t *replyLen, unsigned int timeoutMs)
+ **************************************************************************
+ *  \brief Build and send hostap command, bounding the whole round trip by a deadline
+ *  \param[in] void *context - Provides all the interface information
+ *  \param[in] const char *cmdHeader - The beginning of the hostap command string
+ *  \param[in] FieldsToCmdParse *fieldsToCmdParse - The command parsing information, in which accordingly, the command string (after the header) will be created
+ *  \param[out] char *reply - The output string returning from the hostap command
+ *  \param[in,out] size_t *replyLen - Provide the max output string length, and get back the actual string length
+ *  \param[in] unsigned int timeoutMs - The deadline (in msec) of this command; 0 uses the context's deadline (see dwpal_hostap_cmd_timeout_set)
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, DWPAL_TIMEOUT if no reply within the deadline, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_hostap_cmd_send_timeout(void *context, const char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char *reply /*OUT*/, size_t *replyLen /*IN/OUT*/, unsigned int timeoutMs)
+{
+	if ( (context == NULL) || (cmdHeader == NULL) || (reply == NULL) || (replyLen == NULL) )
+	{
+		console_printf("%s; input params error ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	return hostapCmdSend(context, cmdHeader, fieldsToCmdParse, &reply, replyLen, false /*isReplyAlloc*/, timeoutMs);
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_hostap_cmd_send_alloc(void *context, const char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char **reply, size_t *replyLen, unsigned int timeoutMs)
+ **************************************************************************
+ *  \brief Build and send hostap command, and receive the complete reply, whatever its size is, into a right-sized buffer
+ *  \param[in] void *context - Provides all the interface information
+ *  \param[in] const char *cmdHeader - The beginning of the hostap command string
+ *  \param[in] FieldsToCmdParse *fieldsToCmdParse - The command parsing information, in which accordingly, the command string (after the header) will be created
+ *  \param[out] char **reply - The output string returning from the hostap command; allocated by this function, and should be freed by the caller
+ *  \param[out] size_t *replyLen - The actual string length
+ *  \param[in] unsigned int timeoutMs - The deadline (in msec) of this command; 0 uses the context's deadline (see dwpal_hostap_cmd_timeout_set)
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, DWPAL_TIMEOUT if no reply within the deadline, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_hostap_cmd_send_alloc(void *context, const char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char **reply /*OUT*/, size_t *replyLen /*OUT*/, unsigned int timeoutMs)
+{
+	if ( (context == NULL) || (cmdHeader == NULL) || (reply == NULL) || (replyLen == NULL) )
+	{
+		console_printf("%s; input params error ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	*reply = NULL;
+	*replyLen = 0;
+
+	/* On failure, nothing is left allocated */
+	return hostapCmdSend(context, cmdHeader, fieldsToCmdParse, reply, replyLen, true /*isReplyAlloc*/, timeoutMs);
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_hostap_cmd_timeout_set(void *context, unsigned int timeoutMs)
+ **************************************************************************
+ *  \brief Set the default deadline of the commands sent via this context
+ *  \param[in] void *context - Provides all the interface information
+ *  \param[in] unsigned int timeoutMs - The deadline (in msec) of a command round trip; 0 restores DWPAL_HOSTAPD_CMD_TIMEOUT_MS
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_hostap_cmd_timeout_set(void *context, unsigned int timeoutMs)
+{
+	DWPAL_Context *localContext = (DWPAL_Context *)context;
+
+	if (localContext == NULL)
+	{
+		console_printf("%s; context is NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	localContext->interface.hostapd.cmdTimeoutMs = (timeoutMs == 0) ? DWPAL_HOSTAPD_CMD_TIMEOUT_MS : timeoutMs;
+
+	return DWPAL_SUCCESS;
+}
+
+
 /**************************************************************************/
 /*! \fn DWPAL_Ret dwpal_hostap_event_get(void *context, char *msg , size_t *msgLen, char *opCode)
  **************************************************************************
  *  \brief Will get the complete event and op-code (after internal parsing) from the hostapd (requested event was via fd get)
+ *         It does not block; a ready socket is drained by calling it till it returns DWPAL_NO_PENDING_MESSAGES
  *  \param[in] void *context - Provides all the interface information
  *  \param[out] char *msg - the complete event buffer received from hostapd
  *  \param[in,out] size_t *msgLen - input is buffer size, output is the actual event buffer length copied
  *  \param[out] char *opCode - output the parsed event opcode 
- *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, DWPAL_NO_PENDING_MESSAGES if there is no pending event, other for failure)
  ***************************************************************************/
 DWPAL_Ret dwpal_hostap_event_get(void *context, char *msg /*OUT*/, size_t *msgLen /*IN/OUT*/, char *opCode /*OUT*/)
 {
-	int     ret;
+	ssize_t res;
 	char    *localOpCode;
 	rsize_t dmaxLen;
 	char    *localMsg, *p2str;
@@ -2560,34 +2912,36 @@ DWPAL_Ret dwpal_hostap_event_get(void *context, char *msg /*OUT*/, size_t *msgLe
 		return DWPAL_FAILURE;
 	}
 
-	/* In order to get ALL pending messages (and return the last one), all of the below should be inside "while" loop */
-	ret = wpa_ctrl_pending(wpaCtrlPtr);
-	switch (ret)
+	/* A single non-blocking receive, instead of checking for a pending message first */
+	if ((res = recv(wpa_ctrl_get_fd(wpaCtrlPtr), msg, *msgLen, MSG_TRUNC | MSG_DONTWAIT)) >= 0)
 	{
-		case -1:  /* error */
-			console_printf("%s; wpa_ctrl_pending() returned ERROR ==> Abort!\n", __FUNCTION__);
-			return DWPAL_FAILURE;
-			break;
-
-		case 0:  /* there are no pending messages */
-			return DWPAL_NO_PENDING_MESSAGES;
-			break;
-
-		case 1:  /* there are pending messages */
-			break;
-
-		default:
-			console_printf("%s; wpa_ctrl_pending() returned unknown (%d) value ==> Abort!\n", __FUNCTION__, ret);
-			return DWPAL_FAILURE;
-			break;
-	}
+		if ((size_t)res > *msgLen)
+		{
+			console_printf("%s; event truncated (%d bytes, buffer is %d bytes); use dwpal_hostap_event_len_get to size it\n", __FUNCTION__, (int)res, (int)*msgLen);
+		}
+		else
+		{
+			*msgLen = (size_t)res;
+		}
 
-	/* There are pending messages */
-	if (wpa_ctrl_recv(wpaCtrlPtr, msg, msgLen) == 0)
-	{
 		//console_printf("%s; msgLen= %d\nmsg= '%s'\n", __FUNCTION__, *msgLen, msg);
 		msg[*msgLen] = '\0';
-		if (*msgLen <= 5)
+		clock_gettime(CLOCK_MONOTONIC, &((DWPAL_Context *)context)->interface.hostapd.lastEventTime);
+
+		if (isPongReceived((DWPAL_Context *)context, msg, *msgLen))
+		{  /* the reply of dwpal_hostap_ping_send, and not an event */
+			return DWPAL_NO_PENDING_MESSAGES;
+		}
+		else if (isLevelReplyReceived((DWPAL_Context *)context, msg, *msgLen))
+		{  /* the reply of dwpal_hostap_event_level_set, and not an event */
+			return DWPAL_NO_PENDING_MESSAGES;
+		}
+		else if ( (((DWPAL_Context *)context)->interface.hostapd.wpaCtrlEventCallback != NULL) && (msg[0] != '<') )
+		{  /* two-way connection: a late reply of an abandoned command, and not an event */
+			console_printf("%s; late reply (msgLen= %d) discarded\n", __FUNCTION__, (int)*msgLen);
+			return DWPAL_NO_PENDING_MESSAGES;
+		}
+		else if (*msgLen <= 5)
 		{
 			console_printf("%s; '%s' is NOT a report ==> Abort!\n", __FUNCTION__, msg);
 			return DWPAL_FAILURE;
@@ -2602,9 +2956,13 @@ DWPAL_Ret dwpal_hostap_event_get(void *context, char *msg /*OUT*/, size_t *msgLe
 			free((void *)localMsg);
 		}
 	}
+	else if ( (errno == EAGAIN) || (errno == EWOULDBLOCK) )
+	{  /* there are no pending messages */
+		return DWPAL_NO_PENDING_MESSAGES;
+	}
 	else
 	{
-		console_printf("%s; wpa_ctrl_recv() returned ERROR ==> Abort!\n", __FUNCTION__);
+		console_printf("%s; recv() returned ERROR; errno= %d ('%s') ==> Abort!\n", __FUNCTION__, errno, strerror(errno));
 		return DWPAL_FAILURE;
 	}
 
@@ -2613,23 +2971,378 @@ DWPAL_Ret dwpal_hostap_event_get(void *context, char *msg /*OUT*/, size_t *msgLe
 
 
 /**************************************************************************/
-/*! \fn DWPAL_Ret dwpal_hostap_event_fd_get(void *context, int *fd)
+/*! \fn DWPAL_Ret dwpal_hostap_event_len_get(void *context, size_t *msgLen)
  **************************************************************************
- *  \brief supply the specific hostapd event file descriptor to listen to
+ *  \brief Get the length of the next pending hostapd event, without receiving it; used to size the buffer of dwpal_hostap_event_get
  *  \param[in] void *context - Provides all the interface information
- *  \param[out] int *fd - Provides the interfaces fd value
- *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ *  \param[out] size_t *msgLen - The length of the pending event (not including the terminating NULL)
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, DWPAL_NO_PENDING_MESSAGES if there is no pending event, other for failure)
  ***************************************************************************/
-DWPAL_Ret dwpal_hostap_event_fd_get(void *context, int *fd /*OUT*/)
+DWPAL_Ret dwpal_hostap_event_len_get(void *context, size_t *msgLen /*OUT*/)
 {
-	if ( (context == NULL) || (fd == NULL) )
+	ssize_t res;
+	struct  wpa_ctrl *wpaCtrlPtr = NULL;
+
+	if ( (context == NULL) || (msgLen == NULL) )
 	{
-		//console_printf("%s; context and/or fd is NULL ==> Abort!\n", __FUNCTION__);
+		console_printf("%s; context/msgLen is NULL ==> Abort!\n", __FUNCTION__);
 		return DWPAL_FAILURE;
 	}
 
-	*fd = ((DWPAL_Context *)context)->interface.hostapd.fd;
-
+	wpaCtrlPtr = (((DWPAL_Context *)context)->interface.hostapd.wpaCtrlEventCallback == NULL)?
+	             /* one-way*/ ((DWPAL_Context *)context)->interface.hostapd.listenerWpaCtrlPtr :
+	             /* two-way*/ ((DWPAL_Context *)context)->interface.hostapd.wpaCtrlPtr;
+
+	if (wpaCtrlPtr == NULL)
+	{
+		console_printf("%s; wpaCtrlPtr= NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	res = recv(wpa_ctrl_get_fd(wpaCtrlPtr), NULL, 0, MSG_PEEK | MSG_TRUNC | MSG_DONTWAIT);
+	if (res < 0)
+	{
+		if ( (errno == EAGAIN) || (errno == EWOULDBLOCK) )
+		{
+			return DWPAL_NO_PENDING_MESSAGES;
+		}
+
+		console_printf("%s; recv() returned ERROR; errno= %d ('%s') ==> Abort!\n", __FUNCTION__, errno, strerror(errno));
+		return DWPAL_FAILURE;
+	}
+
+	*msgLen = (size_t)res;
+
+	return DWPAL_SUCCESS;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_hostap_event_opcode_peek(void *context, char *opCode, size_t opCodeSize)
+ **************************************************************************
+ *  \brief Get the op-code of the next pending hostapd event, without receiving it; used to filter the events before receiving them
+ *  \param[in] void *context - Provides all the interface information
+ *  \param[out] char *opCode - The op-code of the pending event; empty in case that the pending message is not an event
+ *               (i.e. a PONG), which should be received via dwpal_hostap_event_get
+ *  \param[in] size_t opCodeSize - The size of opCode
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, DWPAL_NO_PENDING_MESSAGES if there is no pending event, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_hostap_event_opcode_peek(void *context, char *opCode /*OUT*/, size_t opCodeSize)
+{
+	ssize_t res;
+	size_t  len;
+	char    buf[DWPAL_OPCODE_STRING_LENGTH + 8];  /* "<N>" + the op-code; the rest of the event is not copied */
+	char    *p2str;
+	struct  wpa_ctrl *wpaCtrlPtr = NULL;
+
+	if ( (context == NULL) || (opCode == NULL) || (opCodeSize == 0) )
+	{
+		console_printf("%s; context/opCode is NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	wpaCtrlPtr = (((DWPAL_Context *)context)->interface.hostapd.wpaCtrlEventCallback == NULL)?
+	             /* one-way*/ ((DWPAL_Context *)context)->interface.hostapd.listenerWpaCtrlPtr :
+	             /* two-way*/ ((DWPAL_Context *)context)->interface.hostapd.wpaCtrlPtr;
+
+	if (wpaCtrlPtr == NULL)
+	{
+		console_printf("%s; wpaCtrlPtr= NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	res = recv(wpa_ctrl_get_fd(wpaCtrlPtr), buf, sizeof(buf) - 1, MSG_PEEK | MSG_DONTWAIT);
+	if (res < 0)
+	{
+		if ( (errno == EAGAIN) || (errno == EWOULDBLOCK) )
+		{
+			return DWPAL_NO_PENDING_MESSAGES;
+		}
+
+		console_printf("%s; recv() returned ERROR; errno= %d ('%s') ==> Abort!\n", __FUNCTION__, errno, strerror(errno));
+		return DWPAL_FAILURE;
+	}
+
+	buf[res] = '\0';
+	opCode[0] = '\0';
+
+	if ( (buf[0] != '<') || ((p2str = strchr(buf, '>')) == NULL) )
+	{  /* not an event */
+		return DWPAL_SUCCESS;
+	}
+
+	p2str++;
+	len = strcspn(p2str, " ");
+	if (len >= opCodeSize)
+	{
+		len = opCodeSize - 1;
+	}
+
+	memcpy(opCode, p2str, len);
+	opCode[len] = '\0';
+
+	return DWPAL_SUCCESS;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_hostap_event_discard(void *context)
+ **************************************************************************
+ *  \brief Drop the next pending hostapd event without copying it (i.e. an event filtered out via dwpal_hostap_event_opcode_peek)
+ *  \param[in] void *context - Provides all the interface information
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, DWPAL_NO_PENDING_MESSAGES if there is no pending event, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_hostap_event_discard(void *context)
+{
+	struct wpa_ctrl *wpaCtrlPtr = NULL;
+
+	if (context == NULL)
+	{
+		console_printf("%s; context is NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	wpaCtrlPtr = (((DWPAL_Context *)context)->interface.hostapd.wpaCtrlEventCallback == NULL)?
+	             /* one-way*/ ((DWPAL_Context *)context)->interface.hostapd.listenerWpaCtrlPtr :
+	             /* two-way*/ ((DWPAL_Context *)context)->interface.hostapd.wpaCtrlPtr;
+
+	if (wpaCtrlPtr == NULL)
+	{
+		console_printf("%s; wpaCtrlPtr= NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	/* Zero-length receive drops the datagram */
+	if (recv(wpa_ctrl_get_fd(wpaCtrlPtr), NULL, 0, MSG_DONTWAIT) < 0)
+	{
+		if ( (errno == EAGAIN) || (errno == EWOULDBLOCK) )
+		{
+			return DWPAL_NO_PENDING_MESSAGES;
+		}
+
+		console_printf("%s; recv() returned ERROR; errno= %d ('%s') ==> Abort!\n", __FUNCTION__, errno, strerror(errno));
+		return DWPAL_FAILURE;
+	}
+
+	/* A filtered out event proves the hostapd alive as well */
+	clock_gettime(CLOCK_MONOTONIC, &((DWPAL_Context *)context)->interface.hostapd.lastEventTime);
+
+	return DWPAL_SUCCESS;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_hostap_event_level_set(void *context, int level)
+ **************************************************************************
+ *  \brief Set the minimal level (i.e. 3 for MSG_INFO, hostapd's default) of the events hostapd sends to this interface,
+ *         so that lower level events do not cross the socket at all.
+ *         On a one-way interface, the LEVEL is sent on the event socket without waiting; its reply is received via dwpal_hostap_event_get
+ *         (which consumes it, and returns DWPAL_NO_PENDING_MESSAGES); a hostapd that does not support LEVEL keeps sending all the events
+ *  \param[in] void *context - Provides all the interface information
+ *  \param[in] int level - The minimal level of the events to be sent
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_hostap_event_level_set(void *context, int level)
+{
+	DWPAL_Context *localContext = (DWPAL_Context *)context;
+	char          cmd[DWPAL_GENERAL_STRING_LENGTH];
+	char          reply[DWPAL_GENERAL_STRING_LENGTH];
+	char          *replyPtr = reply;
+	size_t        replyLen = sizeof(reply) - 1;
+	DWPAL_Ret     ret;
+
+	if (localContext == NULL)
+	{
+		console_printf("%s; context is NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	snprintf_s(cmd, sizeof(cmd), "LEVEL %d", level);
+
+	if (localContext->interface.hostapd.wpaCtrlEventCallback != NULL)
+	{  /* two-way: the command socket is the attached one */
+		if ((ret = hostapCmdSend(context, cmd, NULL, &replyPtr, &replyLen, false /*isReplyAlloc*/, 0)) != DWPAL_SUCCESS)
+		{
+			return ret;
+		}
+
+		reply[replyLen] = '\0';
+		if (strncmp(reply, "OK", 2))
+		{
+			console_printf("%s; LEVEL is not supported (VAPName= '%s') ==> events are not filtered by hostapd\n", __FUNCTION__, localContext->interface.hostapd.VAPName);
+		}
+
+		return DWPAL_SUCCESS;
+	}
+
+	if (localContext->interface.hostapd.listenerWpaCtrlPtr == NULL)
+	{
+		console_printf("%s; listenerWpaCtrlPtr= NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	/* The listener may not be blocked waiting for the reply; it is received along with the events */
+	if (send(wpa_ctrl_get_fd(localContext->interface.hostapd.listenerWpaCtrlPtr), cmd, strnlen_s(cmd, sizeof(cmd)), MSG_DONTWAIT) < 0)
+	{
+		console_printf("%s; send() fail (VAPName= '%s'); errno= %d ('%s') ==> Abort!\n",
+		               __FUNCTION__, localContext->interface.hostapd.VAPName, errno, strerror(errno));
+		return DWPAL_FAILURE;
+	}
+
+	localContext->interface.hostapd.isLevelReplyPending = true;
+
+	return DWPAL_SUCCESS;
+}
+
+
+/* Send a command that applies to the attached (event) socket, and get its reply.
+ * On a one-way connection, the listener of the event socket should not be running; the events received meanwhile are dropped */
+static DWPAL_Ret eventSocketRequest(DWPAL_Context *localContext, const char *cmd, char *reply /*OUT*/, size_t replySize)
+{
+	char      *replyPtr = reply;
+	size_t    replyLen = replySize - 1;
+	DWPAL_Ret ret;
+
+	if (localContext->interface.hostapd.wpaCtrlEventCallback != NULL)
+	{  /* two-way: the command socket is the attached one */
+		return hostapCmdSend(localContext, cmd, NULL, &replyPtr, &replyLen, false /*isReplyAlloc*/, 0);
+	}
+
+	if (localContext->interface.hostapd.listenerWpaCtrlPtr == NULL)
+	{
+		console_printf("%s; listenerWpaCtrlPtr= NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	ret = hostapdRequest(localContext->interface.hostapd.listenerWpaCtrlPtr, cmd, strnlen_s(cmd, DWPAL_TO_HOSTAPD_MSG_LENGTH),
+	                     &replyPtr, &replyLen, false /*isReplyAlloc*/, NULL, localContext /*PINGs are sent on the event socket*/,
+	                     localContext->interface.hostapd.cmdTimeoutMs);
+	if (ret == DWPAL_SUCCESS)
+	{
+		reply[replyLen] = '\0';
+	}
+
+	return ret;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_hostap_event_reattach(void *context, bool *isDetached)
+ **************************************************************************
+ *  \brief Re-attach the event socket to hostapd. hostapd detaches a monitor whose socket was repeatedly full (i.e. in an events storm),
+ *         and stops sending it events; a re-attach resumes them. Events sent meanwhile are lost, so the interface state should be re-queried.
+ *         On a one-way interface, it should be called from the listener of the event socket (or while it is not listening)
+ *  \param[in] void *context - Provides all the interface information
+ *  \param[out] bool *isDetached - Whether hostapd had detached the event socket
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ *  \note The events level (see dwpal_hostap_event_level_set) is reset to hostapd's default
+ ***************************************************************************/
+DWPAL_Ret dwpal_hostap_event_reattach(void *context, bool *isDetached /*OUT*/)
+{
+	DWPAL_Context *localContext = (DWPAL_Context *)context;
+	char          reply[DWPAL_GENERAL_STRING_LENGTH];
+	DWPAL_Ret     ret;
+
+	if ( (localContext == NULL) || (isDetached == NULL) )
+	{
+		console_printf("%s; context/isDetached is NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	/* DETACH fails in case that hostapd does not know the socket anymore */
+	if ((ret = eventSocketRequest(localContext, "DETACH", reply, sizeof(reply))) != DWPAL_SUCCESS)
+	{
+		console_printf("%s; DETACH (VAPName= '%s') returned ERROR (ret= %d) ==> Abort!\n", __FUNCTION__, localContext->interface.hostapd.VAPName, ret);
+		return ret;
+	}
+
+	*isDetached = (strncmp(reply, "OK", 2) != 0);
+
+	if ((ret = eventSocketRequest(localContext, "ATTACH", reply, sizeof(reply))) != DWPAL_SUCCESS)
+	{
+		console_printf("%s; ATTACH (VAPName= '%s') returned ERROR (ret= %d) ==> Abort!\n", __FUNCTION__, localContext->interface.hostapd.VAPName, ret);
+		return ret;
+	}
+
+	if (strncmp(reply, "OK", 2))
+	{
+		console_printf("%s; ATTACH (VAPName= '%s') failed (reply= '%s') ==> Abort!\n", __FUNCTION__, localContext->interface.hostapd.VAPName, reply);
+		return DWPAL_FAILURE;
+	}
+
+	/* The reply of an earlier LEVEL (if any) was received by now; the level itself was reset by the attach */
+	localContext->interface.hostapd.isLevelReplyPending = false;
+
+	return DWPAL_SUCCESS;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_hostap_event_rcvbuf_set(void *context, int size)
+ **************************************************************************
+ *  \brief Set the receive buffer size (SO_RCVBUF) of the event socket, so that bursts of events are kept till they are received
+ *  \param[in] void *context - Provides all the interface information
+ *  \param[in] int size - The receive buffer size, in bytes (the kernel doubles it, and limits it by net.core.rmem_max)
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ *  \note The number of events a unix socket queues is limited by net.unix.max_dgram_qlen as well
+ ***************************************************************************/
+DWPAL_Ret dwpal_hostap_event_rcvbuf_set(void *context, int size)
+{
+	struct wpa_ctrl *wpaCtrlPtr = NULL;
+	int             effectiveSize = 0;
+	socklen_t       optLen = sizeof(effectiveSize);
+
+	if ( (context == NULL) || (size <= 0) )
+	{
+		console_printf("%s; context is NULL, or size (%d) is not valid ==> Abort!\n", __FUNCTION__, size);
+		return DWPAL_FAILURE;
+	}
+
+	wpaCtrlPtr = (((DWPAL_Context *)context)->interface.hostapd.wpaCtrlEventCallback == NULL)?
+	             /* one-way*/ ((DWPAL_Context *)context)->interface.hostapd.listenerWpaCtrlPtr :
+	             /* two-way*/ ((DWPAL_Context *)context)->interface.hostapd.wpaCtrlPtr;
+
+	if (wpaCtrlPtr == NULL)
+	{
+		console_printf("%s; wpaCtrlPtr= NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	if (setsockopt(wpa_ctrl_get_fd(wpaCtrlPtr), SOL_SOCKET, SO_RCVBUF, &size, sizeof(size)) < 0)
+	{
+		console_printf("%s; setsockopt() fail; errno= %d ('%s') ==> Abort!\n", __FUNCTION__, errno, strerror(errno));
+		return DWPAL_FAILURE;
+	}
+
+	/* The kernel reports the doubled size */
+	if ( (getsockopt(wpa_ctrl_get_fd(wpaCtrlPtr), SOL_SOCKET, SO_RCVBUF, &effectiveSize, &optLen) == 0) && ((effectiveSize / 2) < size) )
+	{
+		console_printf("%s; VAPName= '%s'; receive buffer is limited to %d bytes (net.core.rmem_max)\n",
+		               __FUNCTION__, ((DWPAL_Context *)context)->interface.hostapd.VAPName, effectiveSize / 2);
+	}
+
+	return DWPAL_SUCCESS;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_hostap_event_fd_get(void *context, int *fd)
+ **************************************************************************
+ *  \brief supply the specific hostapd event file descriptor to listen to
+ *  \param[in] void *context - Provides all the interface information
+ *  \param[out] int *fd - Provides the interfaces fd value
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_hostap_event_fd_get(void *context, int *fd /*OUT*/)
+{
+	if ( (context == NULL) || (fd == NULL) )
+	{
+		//console_printf("%s; context and/or fd is NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	*fd = ((DWPAL_Context *)context)->interface.hostapd.fd;
+
 	if (*fd == (-1))
 	{
 		//console_printf("%s; fd value is (-1) ==> Abort!\n", __FUNCTION__);
@@ -2748,6 +3461,100 @@ DWPAL_Ret dwpal_hostap_is_socket_alive(void *context, bool *isExist /*OUT*/)
 }
 
 
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_hostap_ping_send(void *context)
+ **************************************************************************
+ *  \brief Send PING to the hostapd without waiting for its reply; the PONG is received via dwpal_hostap_event_get (which records it,
+ *         and returns DWPAL_NO_PENDING_MESSAGES), and the hostapd liveness is then checked via dwpal_hostap_liveness_get.
+ *         In case that the previous PING was not answered yet, it is sent again (it may have been lost), and the time it is pending
+ *         for is still counted from the first one
+ *  \param[in] void *context - Provides all the interface information
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure, i.e. the hostapd socket does not exist anymore)
+ ***************************************************************************/
+DWPAL_Ret dwpal_hostap_ping_send(void *context)
+{
+	DWPAL_Context    *localContext = (DWPAL_Context *)context;
+	struct wpa_ctrl  *wpaCtrlPtr;
+
+	if (localContext == NULL)
+	{
+		console_printf("%s; context is NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	/* The PONG is sent back to the socket the PING came from; use the one that is being listened to */
+	wpaCtrlPtr = (localContext->interface.hostapd.wpaCtrlEventCallback == NULL)?
+	             /* one-way*/ localContext->interface.hostapd.listenerWpaCtrlPtr :
+	             /* two-way*/ localContext->interface.hostapd.wpaCtrlPtr;
+
+	if (wpaCtrlPtr == NULL)
+	{
+		console_printf("%s; wpaCtrlPtr= NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	if (send(wpa_ctrl_get_fd(wpaCtrlPtr), "PING", sizeof("PING") - 1, MSG_DONTWAIT) < 0)
+	{
+		if ( (errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != ENOBUFS) )
+		{
+			console_printf("%s; send() fail (VAPName= '%s'); errno= %d ('%s') ==> Abort!\n",
+			               __FUNCTION__, localContext->interface.hostapd.VAPName, errno, strerror(errno));
+			return DWPAL_FAILURE;
+		}
+
+		/* hostapd is not reading its socket; the PING is reported as not answered once its deadline passed */
+		console_printf("%s; hostapd socket is congested (VAPName= '%s')\n", __FUNCTION__, localContext->interface.hostapd.VAPName);
+	}
+
+	if (!localContext->interface.hostapd.isPingPending)
+	{
+		localContext->interface.hostapd.isPingPending = true;
+		clock_gettime(CLOCK_MONOTONIC, &localContext->interface.hostapd.pingSendTime);
+	}
+
+	return DWPAL_SUCCESS;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_hostap_liveness_get(void *context, unsigned int *idleMs, unsigned int *pingPendingMs)
+ **************************************************************************
+ *  \brief Get the hostapd activity status, in order to decide whether it should be pinged, or considered as dead
+ *  \param[in] void *context - Provides all the interface information
+ *  \param[out] unsigned int *idleMs - The time (in msec) passed since the last event or command reply received from the hostapd
+ *  \param[out] unsigned int *pingPendingMs - The time (in msec) passed since the PING, sent via dwpal_hostap_ping_send, that is still
+ *               waiting for its PONG; 0 if there is no such PING
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_hostap_liveness_get(void *context, unsigned int *idleMs /*OUT*/, unsigned int *pingPendingMs /*OUT*/)
+{
+	DWPAL_Context *localContext = (DWPAL_Context *)context;
+	unsigned int  eventIdleMs, replyIdleMs;
+
+	if ( (localContext == NULL) || (idleMs == NULL) || (pingPendingMs == NULL) )
+	{
+		console_printf("%s; context/idleMs/pingPendingMs is NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	eventIdleMs = msecElapsedGet(&localContext->interface.hostapd.lastEventTime);
+	replyIdleMs = msecElapsedGet(&localContext->interface.hostapd.lastReplyTime);
+	*idleMs = (eventIdleMs < replyIdleMs) ? eventIdleMs : replyIdleMs;
+
+	*pingPendingMs = 0;
+	if (localContext->interface.hostapd.isPingPending)
+	{
+		*pingPendingMs = msecElapsedGet(&localContext->interface.hostapd.pingSendTime);
+		if (*pingPendingMs == 0)
+		{
+			*pingPendingMs = 1;  /* 0 stands for "no pending PING" */
+		}
+	}
+
+	return DWPAL_SUCCESS;
+}
+
+
 /**************************************************************************/
 /*! \fn DWPAL_Ret dwpal_hostap_interface_detach(void **context)
  **************************************************************************
@@ -2820,6 +3627,116 @@ DWPAL_Ret dwpal_hostap_interface_detach(void **context /*IN/OUT*/)
 }
 
 
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_hostap_abstract_client_socket_set(bool isAbstract)
+ **************************************************************************
+ *  \brief Select where the client sockets of the hostapd/supplicant interfaces to be attached are bound
+ *  \param[in] bool isAbstract - true: in the Linux abstract namespace, so that attach/detach do no file system operations,
+ *                                and no stale socket files are left behind a crash; false (default): under CONFIG_CTRL_IFACE_CLIENT_DIR
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ *  \note Requires the wpa_ctrl.c of this package, that both the Makefile and the yocto_Makefile build; hostap's own wpa_ctrl.c
+ *        ignores it and keeps using CONFIG_CTRL_IFACE_CLIENT_DIR
+ ***************************************************************************/
+DWPAL_Ret dwpal_hostap_abstract_client_socket_set(bool isAbstract)
+{
+	console_printf("%s; isAbstract= %d\n", __FUNCTION__, isAbstract);
+
+	isAbstractClientSocket = isAbstract;
+
+	return DWPAL_SUCCESS;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_hostap_interfaces_enumerate(char VAPNames[][DWPAL_VAP_NAME_STRING_LENGTH], size_t *numOfVAPs)
+ **************************************************************************
+ *  \brief Get the names of the hostapd/supplicant interfaces that are up, according to the control sockets present in their run directories
+ *  \param[out] char VAPNames[][DWPAL_VAP_NAME_STRING_LENGTH] - The interfaces' names (a name present in both directories is listed once)
+ *  \param[in,out] size_t *numOfVAPs - Provide the number of entries in VAPNames, and get back the number of interfaces present;
+ *                 if it is bigger than the provided one, only the first interfaces are copied, and the call may be repeated with a bigger array
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_hostap_interfaces_enumerate(char VAPNames[][DWPAL_VAP_NAME_STRING_LENGTH] /*OUT*/, size_t *numOfVAPs /*IN/OUT*/)
+{
+	size_t        i, j, numOfEntries, numOfFound = 0;
+	bool          isSocket, isExist;
+	DIR           *dir;
+	struct dirent *entry;
+	struct stat   statBuf;
+	char          path[DWPAL_WPA_CTRL_STRING_LENGTH];
+
+	if ( (VAPNames == NULL) || (numOfVAPs == NULL) )
+	{
+		console_printf("%s; VAPNames/numOfVAPs is NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	numOfEntries = *numOfVAPs;
+
+	for (i=0; i < sizeof(hostapSocketDirs) / sizeof(hostapSocketDirs[0]); i++)
+	{
+		if ((dir = opendir(hostapSocketDirs[i])) == NULL)
+		{  /* i.e. no hostapd (or no supplicant) is running */
+			continue;
+		}
+
+		while ((entry = readdir(dir)) != NULL)
+		{
+			/* The global control interface is not an interface of its own */
+			if ( (entry->d_name[0] == '.') || (!strncmp(entry->d_name, "global", sizeof("global"))) ||
+			     (strnlen_s(entry->d_name, DWPAL_VAP_NAME_STRING_LENGTH) >= DWPAL_VAP_NAME_STRING_LENGTH) )
+			{
+				continue;
+			}
+
+			isSocket = (entry->d_type == DT_SOCK);
+			if (entry->d_type == DT_UNKNOWN)
+			{  /* not all file systems report the type */
+				snprintf_s(path, sizeof(path), "%s%s", hostapSocketDirs[i], entry->d_name);
+				isSocket = ( (lstat(path, &statBuf) == 0) && (S_ISSOCK(statBuf.st_mode)) );
+			}
+
+			if (!isSocket)
+			{
+				continue;
+			}
+
+			isExist = false;
+			for (j=0; j < numOfFound && j < numOfEntries; j++)
+			{
+				if (!strncmp(VAPNames[j], entry->d_name, DWPAL_VAP_NAME_STRING_LENGTH))
+				{
+					isExist = true;
+					break;
+				}
+			}
+
+			if (isExist)
+			{
+				continue;
+			}
+
+			if (numOfFound < numOfEntries)
+			{
+				strcpy_s(VAPNames[numOfFound], DWPAL_VAP_NAME_STRING_LENGTH, entry->d_name);
+			}
+			numOfFound++;
+		}
+
+		closedir(dir);
+	}
+
+	if (numOfFound > numOfEntries)
+	{
+		console_printf("%s; %d interfaces found, only %d are copied\n", __FUNCTION__, (int)numOfFound, (int)numOfEntries);
+	}
+
+	*numOfVAPs = numOfFound;
+
+	return DWPAL_SUCCESS;
+}
+
+
 /**************************************************************************/
 /*! \fn DWPAL_Ret dwpal_hostap_interface_attach(void **context, const char *VAPName, DWPAL_wpaCtrlEventCallback wpaCtrlEventCallback)
  **************************************************************************
@@ -2848,13 +3765,6 @@ DWPAL_Ret dwpal_hostap_interface_attach(void **context /*OUT*/, const char *VAPN
 		return DWPAL_FAILURE;
 	}
 
-	/* Temporary due to two-way socket hostapd bug */
-	if (wpaCtrlEventCallback != NULL)
-	{  /* Valid wpaCtrlEventCallback states that this is a two-way connection (for both command and events) */
-		console_printf("%s; currently, two-way connection (for '%s') is NOT supported - use one-way connection ==> Abort!\n", __FUNCTION__, VAPName);
-		return DWPAL_FAILURE;
-	}
-
 	*context = malloc(sizeof(DWPAL_Context));
 	if (*context == NULL)
 	{
@@ -2868,6 +3778,12 @@ DWPAL_Ret dwpal_hostap_interface_attach(void **context /*OUT*/, const char *VAPN
 	localContext->interface.hostapd.VAPName[sizeof(localContext->interface.hostapd.VAPName) - 1] = '\0';
 	localContext->interface.hostapd.fd = -1;
 	localContext->interface.hostapd.wpaCtrlPtr = NULL;
+	localContext->interface.hostapd.cmdTimeoutMs = DWPAL_HOSTAPD_CMD_TIMEOUT_MS;
+	localContext->interface.hostapd.isStaleReplyPossible = false;
+	localContext->interface.hostapd.isPingPending = false;
+	localContext->interface.hostapd.isLevelReplyPending = false;
+	clock_gettime(CLOCK_MONOTONIC, &localContext->interface.hostapd.lastEventTime);
+	localContext->interface.hostapd.lastReplyTime = localContext->interface.hostapd.lastEventTime;
 	localContext->interface.hostapd.wpaCtrlEventCallback = wpaCtrlEventCallback;
 
 	/* check if '/var/run/hostapd/wlanX' or '/var/run/wpa_supplicant/wlanX' exists, and update context's database */
@@ -2903,7 +3819,9 @@ DWPAL_Ret dwpal_hostap_interface_attach(void **context /*OUT*/, const char *VAPN
 	}
 
 	console_printf("%s; wpa_ctrl_open wpaCtrlPtr (for interface '%s')\n", __FUNCTION__, localContext->interface.hostapd.VAPName);
-	localContext->interface.hostapd.wpaCtrlPtr = wpa_ctrl_open(localContext->interface.hostapd.wpaCtrlName);
+	pthread_mutex_lock(&wpaCtrlOpenMutex);
+	localContext->interface.hostapd.wpaCtrlPtr = wpa_ctrl_open2(localContext->interface.hostapd.wpaCtrlName, isAbstractClientSocket ? "@abstract" : NULL);
+	pthread_mutex_unlock(&wpaCtrlOpenMutex);
 	if (localContext->interface.hostapd.wpaCtrlPtr == NULL)
 	{
 		console_printf("%s; wpaCtrlPtr (for interface '%s') is NULL! ==> Abort!\n", __FUNCTION__, localContext->interface.hostapd.VAPName);
@@ -2939,7 +3857,9 @@ DWPAL_Ret dwpal_hostap_interface_attach(void **context /*OUT*/, const char *VAPN
 	else
 	{  /* non-valid wpaCtrlEventCallback states that this is a one-way connection ==> turn on the event listener in an additional socket */
 		console_printf("%s; wpa_ctrl_open listenerWpaCtrlPtr (for interface '%s')\n", __FUNCTION__, localContext->interface.hostapd.VAPName);
-		localContext->interface.hostapd.listenerWpaCtrlPtr = wpa_ctrl_open(localContext->interface.hostapd.wpaCtrlName);
+		pthread_mutex_lock(&wpaCtrlOpenMutex);
+		localContext->interface.hostapd.listenerWpaCtrlPtr = wpa_ctrl_open2(localContext->interface.hostapd.wpaCtrlName, isAbstractClientSocket ? "@abstract" : NULL);
+		pthread_mutex_unlock(&wpaCtrlOpenMutex);
 		console_printf("%s; set up one-way connection for '%s'\n", __FUNCTION__, localContext->interface.hostapd.VAPName);
 		if (localContext->interface.hostapd.listenerWpaCtrlPtr == NULL)
 		{
@@ -69,7 +69,7 @@ void dwpalCliCtrlEventCallback(char *msg, size_t len);
 typedef struct
 {
 	char *interfaceType;
-	char *radioName;
+	char radioName[DWPAL_VAP_NAME_STRING_LENGTH];
 	char *serviceName;
 	int  fd, fdCmdGet;
 } DwpalService;
@@ -243,18 +243,15 @@ typedef struct
 
 
 #if 0
-static DwpalService dwpalService[] = { { "hostap", "wlan0", "TWO_WAY", -1, -1 },  /* Will send commands and get events on the same socket */
+#define HOSTAP_SERVICE_NAME "TWO_WAY"  /* Will send commands and get events on the same socket */
 #else
-static DwpalService dwpalService[] = { { "hostap", "wlan0", "ONE_WAY", -1, -1 },  /* Will send commands and get events on a different socket  */
+#define HOSTAP_SERVICE_NAME "ONE_WAY"  /* Will send commands and get events on a different socket */
 #endif
-                                       { "hostap", "wlan1", "ONE_WAY", -1, -1 },
-                                       { "hostap", "wlan2", "ONE_WAY", -1, -1 },  /* Will send commands and get events on a different socket */
-                                       { "hostap", "wlan3", "ONE_WAY", -1, -1 },
-                                       { "hostap", "wlan4", "ONE_WAY", -1, -1 },
-                                       { "hostap", "wlan5", "ONE_WAY", -1, -1 },
-                                       { "Driver", "ALL",   "TWO_WAY", -1, -1 } };
-
-static void *context[sizeof(dwpalService) / sizeof(DwpalService)] = { [0 ... (sizeof(dwpalService) / sizeof(DwpalService) - 1) ] = NULL };
+
+/* Built by dwpal_init(): an entry per hostapd/supplicant interface present, and the "Driver" entry at the end */
+static DwpalService *dwpalService = NULL;
+static void **context = NULL;
+static int numOfServices = 0;
 static bool isCliRunning = true;
 static char oneShotCommand[DWPAL_TO_HOSTAPD_MSG_LENGTH] = "\0";
 static int numOfListeningEvents = 0, numOfListeningVaps = 0;
@@ -275,6 +272,7 @@ static const char *s_arrDwpalCommands[][2] =
 	{ "DWPAL_HOSTAP_CMD_SEND",         "DWPAL hostap command send"                 },
 	{ "DWPAL_EXT_HOSTAP_IF_ATTACH",    "DWPAL Extender hostap interface attach"    },
 	{ "DWPAL_EXT_HOSTAP_IF_DETACH",    "DWPAL Extender hostap interface detach"    },
+	{ "DWPAL_EXT_HOSTAP_IFS_ATTACH",   "DWPAL Extender attach all hostap interfaces present" },
 	{ "DWPAL_EXT_DRIVER_NL_IF_ATTACH", "DWPAL Extender driver nl interface attach" },
 	{ "DWPAL_EXT_DRIVER_NL_IF_DETACH", "DWPAL Extender driver nl interface detach" },
 	{ "DWPAL_EXT_DRIVER_NL_CMD_SEND",  "DWPAL Extender driver nl command send"     },
@@ -596,19 +594,33 @@ static void dwpal_cli_show_help(void)
 static int interfaceIndexGet(char *interfaceType, const char *radioName)
 {
 	int    i;
-	size_t numOfInterfaces = sizeof(dwpalService) / sizeof(DwpalService);
+	size_t radioNameLen = strnlen_s(radioName, DWPAL_VAP_NAME_STRING_LENGTH);
+	char   *dot;
 
-	for (i=0; i < (int)numOfInterfaces; i++)
+	/* Look for the interface itself; if it is not attached, use its radio's interface (i.e. "wlan2.1" ==> "wlan2") */
+	for (i=0; i < numOfServices; i++)
 	{
 		if ( (!strncmp(interfaceType, dwpalService[i].interfaceType, 6)) &&
-		     (!strncmp(radioName, dwpalService[i].radioName, 5)) &&
-		     ( (!strncmp(dwpalService[i].serviceName, "TWO_WAY", 10)) ||
-		       (!strncmp(dwpalService[i].serviceName, "ONE_WAY", 10)) ) )
+		     (!strncmp(radioName, dwpalService[i].radioName, DWPAL_VAP_NAME_STRING_LENGTH)) )
 		{
 			return i;
 		}
 	}
 
+	if ((dot = strchr(radioName, '.')) != NULL)
+	{
+		radioNameLen = (size_t)(dot - radioName);
+		for (i=0; i < numOfServices; i++)
+		{
+			if ( (!strncmp(interfaceType, dwpalService[i].interfaceType, 6)) &&
+			     (strnlen_s(dwpalService[i].radioName, DWPAL_VAP_NAME_STRING_LENGTH) == radioNameLen) &&
+			     (!strncmp(radioName, dwpalService[i].radioName, radioNameLen)) )
+			{
+				return i;
+			}
+		}
+	}
+
 	return -1;
 }
 
@@ -838,7 +850,7 @@ static DWPAL_Ret dwpal_req_beacon_handle(void *localContext, char *VAPName, char
 		console_printf("%s; malloc error ==> Abort!\n", __FUNCTION__);
 		return DWPAL_FAILURE;
 	}
-	memset((void *)reply, '\0', HOSTAPD_TO_DWPAL_MSG_LENGTH);  /* Clear the output buffer */
+	reply[0] = '\0';  /* The command send NULL terminates the reply */
 
 	snprintf_s(cmd, DWPAL_TO_HOSTAPD_MSG_LENGTH, "REQ_BEACON");
 	for (i=0; i < 9; i++)
@@ -857,7 +869,7 @@ static DWPAL_Ret dwpal_req_beacon_handle(void *localContext, char *VAPName, char
 		ret = dwpal_hostap_cmd_send(localContext, cmd, NULL, reply, &replyLen);
 	}
 
-	if (ret == DWPAL_FAILURE)
+	if (ret != DWPAL_SUCCESS)
 	{
 		console_printf("%s; REQ_BEACON command send error\n", __FUNCTION__);
 	}
@@ -910,7 +922,7 @@ static DWPAL_Ret dwpal_get_sta_measurements_handle(void *localContext, char *VAP
 		console_printf("%s; malloc error ==> Abort!\n", __FUNCTION__);
 		return DWPAL_FAILURE;
 	}
-	memset((void *)reply, '\0', HOSTAPD_TO_DWPAL_MSG_LENGTH);  /* Clear the output buffer */
+	reply[0] = '\0';  /* The command send NULL terminates the reply */
 
 	snprintf_s(cmd, DWPAL_TO_HOSTAPD_MSG_LENGTH, "STA_MEASUREMENTS %s %s", VAPName, MACAddress);
 
@@ -923,7 +935,7 @@ static DWPAL_Ret dwpal_get_sta_measurements_handle(void *localContext, char *VAP
 		ret = dwpal_hostap_cmd_send(localContext, cmd, NULL, reply, &replyLen);
 	}
 
-	if (ret == DWPAL_FAILURE)
+	if (ret != DWPAL_SUCCESS)
 	{
 		console_printf("%s; GET_STA_MEASUREMENTS command send error\n", __FUNCTION__);
 	}
@@ -1001,7 +1013,7 @@ static DWPAL_Ret dwpal_get_vap_measurements_handle(void *localContext, char *VAP
 		console_printf("%s; malloc error ==> Abort!\n", __FUNCTION__);
 		return DWPAL_FAILURE;
 	}
-	memset((void *)reply, '\0', HOSTAPD_TO_DWPAL_MSG_LENGTH);  /* Clear the output buffer */
+	reply[0] = '\0';  /* The command send NULL terminates the reply */
 
 	snprintf_s(cmd, DWPAL_TO_HOSTAPD_MSG_LENGTH, "GET_VAP_MEASUREMENTS %s", VAPName);
 	console_printf("%s; cmd= '%s'\n", __FUNCTION__, cmd);
@@ -1015,7 +1027,7 @@ static DWPAL_Ret dwpal_get_vap_measurements_handle(void *localContext, char *VAP
 		ret = dwpal_hostap_cmd_send(localContext, cmd, NULL, reply, &replyLen);
 	}
 
-	if (ret == DWPAL_FAILURE)
+	if (ret != DWPAL_SUCCESS)
 	{
 		console_printf("%s; GET_VAP_MEASUREMENTS command send error\n", __FUNCTION__);
 	}
@@ -1082,7 +1094,7 @@ static DWPAL_Ret dwpal_get_restricted_channels_handle(void *localContext, char *
 		console_printf("%s; malloc error ==> Abort!\n", __FUNCTION__);
 		return DWPAL_FAILURE;
 	}
-	memset((void *)reply, '\0', HOSTAPD_TO_DWPAL_MSG_LENGTH);  /* Clear the output buffer */
+	reply[0] = '\0';  /* The command send NULL terminates the reply */
 
 	if (isDwpalExtenderMode)
 	{
@@ -1093,7 +1105,7 @@ static DWPAL_Ret dwpal_get_restricted_channels_handle(void *localContext, char *
 		ret = dwpal_hostap_cmd_send(localContext, "GET_RESTRICTED_CHANNELS", NULL, reply, &replyLen);
 	}
 
-	if (ret == DWPAL_FAILURE)
+	if (ret != DWPAL_SUCCESS)
 	{
 		console_printf("%s; GET_RESTRICTED_CHANNELS command send error\n", __FUNCTION__);
 	}
@@ -1144,7 +1156,7 @@ static DWPAL_Ret dwpal_get_failsafe_channel_handle(void *localContext, char *VAP
 		console_printf("%s; malloc error ==> Abort!\n", __FUNCTION__);
 		return DWPAL_FAILURE;
 	}
-	memset((void *)reply, '\0', HOSTAPD_TO_DWPAL_MSG_LENGTH);  /* Clear the output buffer */
+	reply[0] = '\0';  /* The command send NULL terminates the reply */
 
 	if (isDwpalExtenderMode)
 	{
@@ -1155,7 +1167,7 @@ static DWPAL_Ret dwpal_get_failsafe_channel_handle(void *localContext, char *VAP
 		ret = dwpal_hostap_cmd_send(localContext, "GET_FAILSAFE_CHAN", NULL, reply, &replyLen);
 	}
 
-	if (ret == DWPAL_FAILURE)
+	if (ret != DWPAL_SUCCESS)
 	{
 		console_printf("%s; GET_FAILSAFE_CHAN command send error\n", __FUNCTION__);
 	}
@@ -1234,7 +1246,7 @@ static DWPAL_Ret dwpal_radio_info_handle(void *localContext, char *VAPName, bool
 		console_printf("%s; malloc error ==> Abort!\n", __FUNCTION__);
 		return DWPAL_FAILURE;
 	}
-	memset((void *)reply, '\0', HOSTAPD_TO_DWPAL_MSG_LENGTH);  /* Clear the output buffer */
+	reply[0] = '\0';  /* The command send NULL terminates the reply */
 
 	if (isDwpalExtenderMode)
 	{
@@ -1245,7 +1257,7 @@ static DWPAL_Ret dwpal_radio_info_handle(void *localContext, char *VAPName, bool
 		ret = dwpal_hostap_cmd_send(localContext, "GET_RADIO_INFO", NULL, reply, &replyLen);
 	}
 
-	if (ret == DWPAL_FAILURE)
+	if (ret != DWPAL_SUCCESS)
 	{
 		console_printf("%s; GET_RADIO_INFO command send error\n", __FUNCTION__);
 	}
@@ -1331,7 +1343,7 @@ static DWPAL_Ret dwpal_acs_report_handle(void *localContext, char *VAPName, bool
 		console_printf("%s; malloc error ==> Abort!\n", __FUNCTION__);
 		return DWPAL_FAILURE;
 	}
-	memset((void *)reply, '\0', HOSTAPD_TO_DWPAL_MSG_LENGTH);  /* Clear the output buffer */
+	reply[0] = '\0';  /* The command send NULL terminates the reply */
 
 	if (isDwpalExtenderMode)
 	{
@@ -1342,7 +1354,7 @@ static DWPAL_Ret dwpal_acs_report_handle(void *localContext, char *VAPName, bool
 		ret = dwpal_hostap_cmd_send(localContext, "GET_ACS_REPORT", NULL, reply, &replyLen);
 	}
 
-	if (ret == DWPAL_FAILURE)
+	if (ret != DWPAL_SUCCESS)
 	{
 		console_printf("%s; GET_ACS_REPORT command send error\n", __FUNCTION__);
 	}
@@ -2159,8 +2171,8 @@ static DWPAL_Ret hostapdEventHandle(char *opCode, char *msg, size_t msgLen)
 
 static void *listenerThreadStart(void *temp)
 {
-	int     i, highestValFD, ret, numOfServices = sizeof(dwpalService) / sizeof(DwpalService);
-	char    *msg;
+	int     i, highestValFD, ret;
+	static char msg[HOSTAPD_TO_DWPAL_MSG_LENGTH];  /* owned by the listener thread, and reused by all of the events */
 	size_t  msgLen, msgStringLen;
 	fd_set  rfds;
 	char    opCode[DWPAL_OPCODE_STRING_LENGTH];
@@ -2241,15 +2253,8 @@ static void *listenerThreadStart(void *temp)
 						/*console_printf("%s; event received; interfaceType= '%s', radioName= '%s', serviceName= '%s'\n",
 						       __FUNCTION__, dwpalService[i].interfaceType, dwpalService[i].radioName, dwpalService[i].serviceName);*/
 
-						msg = (char *)malloc((size_t)(HOSTAPD_TO_DWPAL_MSG_LENGTH * sizeof(char)));
-						if (msg == NULL)
-						{
-							console_printf("%s; invalid input ('msg') parameter ==> Abort!\n", __FUNCTION__);
-							break;
-						}
-
-						memset(msg, 0, HOSTAPD_TO_DWPAL_MSG_LENGTH * sizeof(char));  /* Clear the output buffer */
-						memset(opCode, 0, sizeof(opCode));
+						/* dwpal_hostap_event_get() NULL terminates the received event */
+						opCode[0] = '\0';
 						msgLen = HOSTAPD_TO_DWPAL_MSG_LENGTH - 1;  //was "msgLen = HOSTAPD_TO_DWPAL_MSG_LENGTH;"
 
 						if (dwpal_hostap_event_get(context[i], msg /*OUT*/, &msgLen /*IN/OUT*/, opCode /*OUT*/) == DWPAL_FAILURE)
@@ -2330,8 +2335,6 @@ static void *listenerThreadStart(void *temp)
 								}
 							}
 						}
-
-						free((void *)msg);
 					}
 				}
 			}
@@ -2370,7 +2373,6 @@ static DWPAL_Ret listenerThreadCreate(void)
 	int            ret;
 	DWPAL_Ret      dwpalRet = DWPAL_SUCCESS;
 	pthread_attr_t attr;
-	size_t         stack_size = 4096;
 	//void           *res;
 	pthread_t      thread_id;
 
@@ -2383,13 +2385,7 @@ static DWPAL_Ret listenerThreadCreate(void)
 		return DWPAL_FAILURE;
 	}
 
-	ret = pthread_attr_setstacksize(&attr, stack_size);
-	if (ret == -1)
-	{
-		console_printf("%s; pthread_attr_setstacksize ERROR (ret= %d) ==> Abort!\n", __FUNCTION__, ret);
-		dwpalRet = DWPAL_FAILURE;
-	}
-
+	/* The system default stack; a 4096 bytes one is below PTHREAD_STACK_MIN, and too small for parsing the events on it anyway */
 	if (dwpalRet == DWPAL_SUCCESS)
 	{
 		console_printf("%s; call pthread_create\n", __FUNCTION__);
@@ -2431,19 +2427,127 @@ static DWPAL_Ret listenerThreadCreate(void)
 }
 
 
+static void *interfaceSetThreadStart(void *temp)
+{
+	DwpalService *dwpalServiceLocal = (DwpalService *)temp;
+	int          idx = (int)(dwpalServiceLocal - dwpalService);
+
+	if (interfaceSet(dwpalServiceLocal, idx) == DWPAL_SUCCESS)
+	{
+		console_printf("%s; interfaceSet (radioName= '%s', serviceName= '%s') successfully\n", __FUNCTION__, dwpalServiceLocal->radioName, dwpalServiceLocal->serviceName);
+	}
+
+	return NULL;
+}
+
+
+/* Get the interfaces whose control sockets are present; the array is allocated here (freed by the caller) */
+static char (*hostapInterfacesEnumerate(size_t *numOfVAPs /*OUT*/))[DWPAL_VAP_NAME_STRING_LENGTH]
+{
+	size_t numOfEntries = NUM_OF_SUPPORTED_VAPS;
+	char   (*VAPNames)[DWPAL_VAP_NAME_STRING_LENGTH];
+
+	while (true)
+	{
+		if ((VAPNames = malloc(numOfEntries * DWPAL_VAP_NAME_STRING_LENGTH)) == NULL)
+		{
+			console_printf("%s; malloc (%d entries) ERROR ==> Abort!\n", __FUNCTION__, (int)numOfEntries);
+			return NULL;
+		}
+
+		*numOfVAPs = numOfEntries;
+		if (dwpal_hostap_interfaces_enumerate(VAPNames, numOfVAPs /*IN/OUT*/) == DWPAL_FAILURE)
+		{
+			console_printf("%s; dwpal_hostap_interfaces_enumerate returned ERROR ==> Abort!\n", __FUNCTION__);
+			free((void *)VAPNames);
+			return NULL;
+		}
+
+		if (*numOfVAPs <= numOfEntries)
+		{
+			return VAPNames;
+		}
+
+		/* More interfaces than entries; retry with room for all of them */
+		numOfEntries = *numOfVAPs;
+		free((void *)VAPNames);
+	}
+}
+
+
 static void dwpal_init(void)
 {
-	int i, numOfServices = sizeof(dwpalService) / sizeof(DwpalService);
+	int       i;
+	size_t    numOfVAPs = 0;
+	char      (*VAPNames)[DWPAL_VAP_NAME_STRING_LENGTH];
+	pthread_t *threadIds;
+
+	if (dwpalService != NULL)
+	{
+		console_printf("%s; already initialized ==> cont...\n", __FUNCTION__);
+		return;
+	}
+
+	/* Build the services of the interfaces actually present, instead of a fixed list of radios */
+	if ((VAPNames = hostapInterfacesEnumerate(&numOfVAPs /*OUT*/)) == NULL)
+	{
+		return;
+	}
+
+	dwpalService = (DwpalService *)malloc((numOfVAPs + 1) * sizeof(DwpalService));
+	context = (void **)calloc(numOfVAPs + 1, sizeof(void *));
+	threadIds = (pthread_t *)malloc((numOfVAPs + 1) * sizeof(pthread_t));
+	if ( (dwpalService == NULL) || (context == NULL) || (threadIds == NULL) )
+	{
+		console_printf("%s; malloc (%d services) ERROR ==> Abort!\n", __FUNCTION__, (int)numOfVAPs + 1);
+		free((void *)dwpalService);
+		free((void *)context);
+		free((void *)threadIds);
+		free((void *)VAPNames);
+		dwpalService = NULL;
+		context = NULL;
+		return;
+	}
 
-	/* Init the services */
+	for (i=0; i < (int)numOfVAPs; i++)
+	{
+		dwpalService[i].interfaceType = "hostap";
+		strcpy_s(dwpalService[i].radioName, DWPAL_VAP_NAME_STRING_LENGTH, VAPNames[i]);
+		dwpalService[i].serviceName = HOSTAP_SERVICE_NAME;
+		dwpalService[i].fd = -1;
+		dwpalService[i].fdCmdGet = -1;
+	}
+
+	dwpalService[numOfVAPs].interfaceType = "Driver";
+	strcpy_s(dwpalService[numOfVAPs].radioName, DWPAL_VAP_NAME_STRING_LENGTH, "ALL");
+	dwpalService[numOfVAPs].serviceName = "TWO_WAY";
+	dwpalService[numOfVAPs].fd = -1;
+	dwpalService[numOfVAPs].fdCmdGet = -1;
+
+	numOfServices = (int)numOfVAPs + 1;
+	free((void *)VAPNames);
+
+	/* Init the services - in parallel, each attach waits for its own hostapd reply */
 	for (i=0; i < numOfServices; i++)
 	{
-		if (interfaceSet(&dwpalService[i], i) == DWPAL_SUCCESS)
+		if (pthread_create(&threadIds[i], NULL, interfaceSetThreadStart, (void *)&dwpalService[i]) != 0)
 		{
-			console_printf("%s; interfaceSet (radioName= '%s', serviceName= '%s') successfully\n", __FUNCTION__, dwpalService[i].radioName, dwpalService[i].serviceName);
+			console_printf("%s; pthread_create (radioName= '%s') ERROR ==> attach inline\n", __FUNCTION__, dwpalService[i].radioName);
+			interfaceSetThreadStart((void *)&dwpalService[i]);
+			threadIds[i] = pthread_self();
 		}
 	}
 
+	for (i=0; i < numOfServices; i++)
+	{
+		if (!pthread_equal(threadIds[i], pthread_self()))
+		{
+			pthread_join(threadIds[i], NULL);
+		}
+	}
+
+	free((void *)threadIds);
+
 	/* Start the listener thread */
 	if (listenerThreadCreate() == DWPAL_FAILURE)
 	{
@@ -2457,6 +2561,7 @@ static void dwpal_cli_readline_callback(char *strLine)
 {
 	int                             i, idx;
 	char                            *p2str, *opCode, *VAPName = NULL, *hostapCmdOpcode, *field;
+	void                            *hostapContext;
 	rsize_t                         dmaxLen;
 	static bool                     isDwpalExtenderMode = false;
 	enum nl80211_commands           nl80211Command;
@@ -2515,6 +2620,41 @@ static void dwpal_cli_readline_callback(char *strLine)
 		isDwpalExtenderMode = false;
 		dwpal_init();
 	}
+	else if (!strncmp(opCode, "DWPAL_EXT_HOSTAP_IFS_ATTACH", strnlen_s("DWPAL_EXT_HOSTAP_IFS_ATTACH", DWPAL_GENERAL_STRING_LENGTH)))
+	{
+		/* Format: DWPAL_EXT_HOSTAP_IFS_ATTACH - attach all the interfaces present */
+		size_t numOfVAPs = 0;
+		char   (*VAPNames)[DWPAL_VAP_NAME_STRING_LENGTH] = hostapInterfacesEnumerate(&numOfVAPs /*OUT*/);
+		char   **VAPNamesPtr;
+
+		if (VAPNames != NULL)
+		{
+			if ((VAPNamesPtr = (char **)malloc((numOfVAPs + 1) * sizeof(char *))) == NULL)
+			{
+				console_printf("%s; malloc ERROR ==> Abort!\n", __FUNCTION__);
+			}
+			else
+			{
+				for (i=0; i < (int)numOfVAPs; i++)
+				{
+					VAPNamesPtr[i] = VAPNames[i];
+				}
+
+				if (dwpal_ext_hostap_interfaces_attach(VAPNamesPtr, numOfVAPs, dwpalExtEventCallback) == DWPAL_FAILURE)
+				{
+					console_printf("%s; dwpal_ext_hostap_interfaces_attach returned ERROR (numOfVAPs= %d) ==> Abort!\n", __FUNCTION__, (int)numOfVAPs);
+				}
+				else
+				{
+					isDwpalExtenderMode = true;
+				}
+
+				free((void *)VAPNamesPtr);
+			}
+
+			free((void *)VAPNames);
+		}
+	}
 	else if (!strncmp(opCode, "DWPAL_EXT_DRIVER_NL_IF_ATTACH", strnlen_s("DWPAL_EXT_DRIVER_NL_IF_ATTACH", DWPAL_GENERAL_STRING_LENGTH)))
 	{
 		/* Format: DWPAL_EXT_DRIVER_NL_IF_ATTACH */
@@ -2565,11 +2705,13 @@ static void dwpal_cli_readline_callback(char *strLine)
 				   DWPAL_HOSTAP_CMD_SEND wlan2 REQ_BEACON 44:85:00:C5:6A:1B 0 0 0 255 1000 50 passive 00:0A:1B:0E:04:60 beacon_rep=1,123
 				*/
 
-				if ((idx = interfaceIndexGet("hostap", VAPName)) == -1)
+				/* In extender mode, the commands are sent by VAPName */
+				if ( ((idx = interfaceIndexGet("hostap", VAPName)) == -1) && (!isDwpalExtenderMode) )
 				{
 					console_printf("%s; interfaceIndexGet (radioName= '%s', serviceName= 'Both') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
 					return;
 				}
+				hostapContext = (idx == -1) ? NULL : context[idx];
 
 				hostapCmdOpcode = strtok_s(NULL, &dmaxLen, " ", &p2str);
 				if (hostapCmdOpcode == NULL)
@@ -2580,51 +2722,51 @@ static void dwpal_cli_readline_callback(char *strLine)
 
 				if (!strncmp(hostapCmdOpcode, "GET_ACS_REPORT", strnlen_s("GET_ACS_REPORT", DWPAL_GENERAL_STRING_LENGTH)))
 				{
-					if (dwpal_acs_report_handle(context[idx], VAPName, isDwpalExtenderMode) == DWPAL_FAILURE)
+					if (dwpal_acs_report_handle(hostapContext, VAPName, isDwpalExtenderMode) == DWPAL_FAILURE)
 					{
-						console_printf("%s; dwpal_acs_report_get (VAPName= '%s', serviceName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName, dwpalService[idx].serviceName);
+						console_printf("%s; dwpal_acs_report_get (VAPName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
 					}
 				}
 				else if (!strncmp(hostapCmdOpcode, "GET_RADIO_INFO", strnlen_s("GET_RADIO_INFO", DWPAL_GENERAL_STRING_LENGTH)))
 				{
-					if (dwpal_radio_info_handle(context[idx], VAPName, isDwpalExtenderMode) == DWPAL_FAILURE)
+					if (dwpal_radio_info_handle(hostapContext, VAPName, isDwpalExtenderMode) == DWPAL_FAILURE)
 					{
-						console_printf("%s; dwpal_radio_info_handle (VAPName= '%s', serviceName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName, dwpalService[idx].serviceName);
+						console_printf("%s; dwpal_radio_info_handle (VAPName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
 					}
 				}
 				else if (!strncmp(hostapCmdOpcode, "GET_FAILSAFE_CHAN", strnlen_s("GET_FAILSAFE_CHAN", DWPAL_GENERAL_STRING_LENGTH)))
 				{
-					if (dwpal_get_failsafe_channel_handle(context[idx], VAPName, isDwpalExtenderMode) == DWPAL_FAILURE)
+					if (dwpal_get_failsafe_channel_handle(hostapContext, VAPName, isDwpalExtenderMode) == DWPAL_FAILURE)
 					{
-						console_printf("%s; dwpal_get_failsafe_channel_handle (VAPName= '%s', serviceName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName, dwpalService[idx].serviceName);
+						console_printf("%s; dwpal_get_failsafe_channel_handle (VAPName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
 					}
 				}
 				else if (!strncmp(hostapCmdOpcode, "GET_RESTRICTED_CHANNELS", strnlen_s("GET_RESTRICTED_CHANNELS", DWPAL_GENERAL_STRING_LENGTH)))
 				{
-					if (dwpal_get_restricted_channels_handle(context[idx], VAPName, isDwpalExtenderMode) == DWPAL_FAILURE)
+					if (dwpal_get_restricted_channels_handle(hostapContext, VAPName, isDwpalExtenderMode) == DWPAL_FAILURE)
 					{
-						console_printf("%s; dwpal_get_restricted_channels_handle (VAPName= '%s', serviceName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName, dwpalService[idx].serviceName);
+						console_printf("%s; dwpal_get_restricted_channels_handle (VAPName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
 					}
 				}
 				else if (!strncmp(hostapCmdOpcode, "GET_VAP_MEASUREMENTS", strnlen_s("GET_VAP_MEASUREMENTS", DWPAL_GENERAL_STRING_LENGTH)))
 				{
-					if (dwpal_get_vap_measurements_handle(context[idx], VAPName, isDwpalExtenderMode) == DWPAL_FAILURE)
+					if (dwpal_get_vap_measurements_handle(hostapContext, VAPName, isDwpalExtenderMode) == DWPAL_FAILURE)
 					{
-						console_printf("%s; dwpal_get_vap_measurements_handle (VAPName= '%s', serviceName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName, dwpalService[idx].serviceName);
+						console_printf("%s; dwpal_get_vap_measurements_handle (VAPName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
 					}
 				}
 				else if (!strncmp(hostapCmdOpcode, "STA_MEASUREMENTS", strnlen_s("STA_MEASUREMENTS", DWPAL_GENERAL_STRING_LENGTH)))
 				{
 					if ( (field = strtok_s(NULL, &dmaxLen, " ", &p2str)) != NULL)
 					{
-						if (dwpal_get_sta_measurements_handle(context[idx], VAPName, field, isDwpalExtenderMode) == DWPAL_FAILURE)
+						if (dwpal_get_sta_measurements_handle(hostapContext, VAPName, field, isDwpalExtenderMode) == DWPAL_FAILURE)
 						{
-							console_printf("%s; dwpal_get_sta_measurements_handle (VAPName= '%s', serviceName= '%s', MACAddress= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName, dwpalService[idx].serviceName, field);
+							console_printf("%s; dwpal_get_sta_measurements_handle (VAPName= '%s', MACAddress= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName, field);
 						}
 					}
 					else
 					{
-						console_printf("%s; dwpal_get_sta_measurements_handle (VAPName= '%s', serviceName= '%s') no MAC Address ==> Abort!\n", __FUNCTION__, VAPName, dwpalService[idx].serviceName);
+						console_printf("%s; dwpal_get_sta_measurements_handle (VAPName= '%s') no MAC Address ==> Abort!\n", __FUNCTION__, VAPName);
 					}
 				}
 				else if (!strncmp(hostapCmdOpcode, "REQ_BEACON", strnlen_s("REQ_BEACON", DWPAL_GENERAL_STRING_LENGTH)))
@@ -2636,16 +2778,16 @@ static void dwpal_cli_readline_callback(char *strLine)
 						fields[i] = strtok_s(NULL, &dmaxLen, " ", &p2str);
 						if (fields[i] == NULL)
 						{
-							console_printf("%s; dwpal_req_beacon_handle (VAPName= '%s', serviceName= '%s') returned ERROR (i= %d) ==> Abort!\n", __FUNCTION__, VAPName, dwpalService[idx].serviceName, i);
+							console_printf("%s; dwpal_req_beacon_handle (VAPName= '%s') returned ERROR (i= %d) ==> Abort!\n", __FUNCTION__, VAPName, i);
 							break;
 						}
 					}
 
 					if (i >= 9)
 					{
-						if (dwpal_req_beacon_handle(context[idx], VAPName, fields, isDwpalExtenderMode) == DWPAL_FAILURE)
+						if (dwpal_req_beacon_handle(hostapContext, VAPName, fields, isDwpalExtenderMode) == DWPAL_FAILURE)
 						{
-							console_printf("%s; dwpal_req_beacon_handle (VAPName= '%s', serviceName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName, dwpalService[idx].serviceName);
+							console_printf("%s; dwpal_req_beacon_handle (VAPName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
 						}
 					}
 				}
@@ -2675,10 +2817,10 @@ static void dwpal_cli_readline_callback(char *strLine)
 						}
 						else
 						{
-							ret = dwpal_hostap_cmd_send(context[idx], cmd, NULL, reply, &replyLen);
+							ret = dwpal_hostap_cmd_send(hostapContext, cmd, NULL, reply, &replyLen);
 						}
 
-						if (ret == DWPAL_FAILURE)
+						if (ret != DWPAL_SUCCESS)
 						{
 							console_printf("%s; dwpal_hostap_cmd_send (VAPName= '%s', cmd= '%s') returned ERROR (reply= '%s') ==> Abort!\n", __FUNCTION__, VAPName, cmd, reply);
 						}
@@ -2692,12 +2834,6 @@ static void dwpal_cli_readline_callback(char *strLine)
 			else if (!strncmp(opCode, "DWPAL_EXT_HOSTAP_IF_ATTACH", strnlen_s("DWPAL_EXT_HOSTAP_IF_ATTACH", DWPAL_GENERAL_STRING_LENGTH)))
 			{
 				/* Format: DWPAL_EXT_HOSTAP_IF_ATTACH */
-				if ((idx = interfaceIndexGet("hostap", VAPName)) == -1)
-				{
-					console_printf("%s; interfaceIndexGet (radioName= '%s', serviceName= 'Both') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
-					return;
-				}
-
 				if (dwpal_ext_hostap_interface_attach(VAPName, dwpalExtEventCallback) == DWPAL_FAILURE)
 				{
 					console_printf("%s; dwpal_ext_hostap_interface_attach returned ERROR (VAPName= '%s') ==> Abort!\n", __FUNCTION__, VAPName);
@@ -2710,12 +2846,6 @@ static void dwpal_cli_readline_callback(char *strLine)
 			else if (!strncmp(opCode, "DWPAL_EXT_HOSTAP_IF_DETACH", strnlen_s("DWPAL_EXT_HOSTAP_IF_DETACH", DWPAL_GENERAL_STRING_LENGTH)))
 			{
 				/* Format: DWPAL_EXT_HOSTAP_IF_DETACH */
-				if ((idx = interfaceIndexGet("hostap", VAPName)) == -1)
-				{
-					console_printf("%s; interfaceIndexGet (radioName= '%s', serviceName= 'Both') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
-					return;
-				}
-
 				if (dwpal_ext_hostap_interface_detach(VAPName) == DWPAL_FAILURE)
 				{
 					console_printf("%s; dwpal_ext_hostap_interface_detach returned ERROR (VAPName= '%s') ==> Abort!\n", __FUNCTION__, VAPName);
@@ -2940,7 +3070,7 @@ static void dwpal_cli_readline_callback(char *strLine)
 
 static void dwpalCliStart(void)
 {
-	int    i, res, numOfServices = sizeof(dwpalService) / sizeof(DwpalService);
+	int    i, res;
 	fd_set rfds;
 
 	console_printf("%s Entry\n", __FUNCTION__);
@@ -3294,7 +3424,7 @@ int main(int argc, char *argv[])
 
 					if (oneShotCommand[0] != '\0')
 					{
-						if (dwpal_ext_hostap_cmd_send(oneShotInterfaceName[0], oneShotCommand, NULL, reply, &replyLen) == DWPAL_FAILURE)
+						if (dwpal_ext_hostap_cmd_send(oneShotInterfaceName[0], oneShotCommand, NULL, reply, &replyLen) != DWPAL_SUCCESS)
 						{
 							console_printf("%s; dwpal_hostap_cmd_send (oneShotInterfaceName[0]= '%s', oneShotCommand= '%s') returned ERROR (reply= '%s') ==> Abort!\n",
 							               __FUNCTION__, oneShotInterfaceName[0], oneShotCommand, reply);
@@ -4,6 +4,8 @@
  *                                                                              *
  *  *****************************************************************************/
 
+#define _GNU_SOURCE  /* pthread_attr_setaffinity_np, pthread_setname_np */
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -11,6 +13,12 @@
 #include <unistd.h>
 #include <pthread.h>
 #include <time.h>
+#include <sys/inotify.h>
+#include <sys/epoll.h>
+#include <stdint.h>
+#include <semaphore.h>
+#include <sched.h>
+#include <limits.h>
 
 #if defined YOCTO
 #include <slibc/string.h>
@@ -22,12 +30,40 @@
 #include "dwpal_ext.h"
 #include "dwpal_log.h"	//Logging
 
-/* Dedicated thread for hostapd event callbacks */
+/* Dedicated thread for hostapd event callbacks; the default of dwpal_ext_callback_workers_set */
 //#define EVENT_CALLBACK_THREAD
 
-#define PING_CHECK_TIME 3
+#define PING_CHECK_TIME 3  /* an interface that was silent (no events, no replies) for this long is pinged */
+#define PING_MISSED_PONGS_MAX 3  /* the PING deadlines passed without a PONG (the PING is re-sent on each) before the recovery */
+#define PONG_TIMEOUT_MS 2000  /* the deadline of a PING; a hung hostapd is recovered after PING_MISSED_PONGS_MAX of these */
 #define RECOVERY_RETRY_TIME 1
-#define EVENT_HANDLER_SOCKET "/tmp/dwpal_event_handler_socket"
+#define RECOVERY_FALLBACK_RETRY_TIME 10  /* when hostapd sockets are watched via inotify, polling is only a safety net */
+#define HOSTAP_SOCKET_DIRS_PARENT "/var/run"
+#define NUM_OF_CACHED_COMMANDS 16
+#define NUM_OF_COALESCED_OPCODES 16
+#define NUM_OF_HIGH_PRIORITY_OPCODES 16
+#define EVENT_QUEUE_OPCODE_STATS_MAX 32  /* the op-codes whose queue counters are kept per interface */
+#define SERVICES_INITIAL_SIZE 32  /* must be a power of 2; the services' tables are doubled whenever full */
+#define HOSTAP_DEFAULT_EVENT_LEVEL 3  /* MSG_INFO; the level hostapd sends events from, unless set via LEVEL */
+#define UNIX_DGRAM_QUEUE_LIMIT_FILE "/proc/sys/net/unix/max_dgram_qlen"
+#define UNIX_DGRAM_DEFAULT_QUEUE_LIMIT 10
+#define MAC_ADDR_STRING_LENGTH 18
+#define LISTENER_EPOLL_MAX_EVENTS 64
+#define EVENT_QUEUE_SIZE 256  /* must be a power of 2; the events queued for each callback worker */
+#define CALLBACK_WORKERS_MAX 16
+#if defined EVENT_CALLBACK_THREAD
+#define CALLBACK_WORKERS_DEFAULT 1
+#else
+#define CALLBACK_WORKERS_DEFAULT 0  /* the callbacks are called by the listener thread itself */
+#endif
+#define EVENT_BUFFER_POOL_SIZE 8  /* the listener's reusable event buffers (HOSTAPD_TO_DWPAL_MSG_LENGTH bytes each) */
+#define HOSTAP_EVENT_DRAIN_BUDGET 32  /* the events received from a ready interface per listener round, for the others not to starve */
+#define HOSTAP_EVENT_OVERFLOW_ROUNDS 3  /* the consecutive listener rounds an event socket stays full before an overflow is suspected */
+#define HOSTAP_STATE_ROUND_BUDGET_MS 50  /* the time a listener round spends on state snapshots; they are continued on the next round */
+#define HOSTAP_STATE_CMD_TIMEOUTS_MAX 3  /* the times a snapshot command may time out with a whole round's budget before the snapshot fails */
+#define LISTENER_EPOLL_PIPE 0  /* epoll tags of the listener's own fds; the services' tags are their index + LISTENER_EPOLL_SERVICE_BASE */
+#define LISTENER_EPOLL_INOTIFY 1
+#define LISTENER_EPOLL_SERVICE_BASE 2
 
 
 typedef enum
@@ -36,62 +72,293 @@ typedef enum
 	THREAD_CREATE
 } DwpalThreadOperation;
 
+/* The last known state of a hostap interface, for the diff delivered after its reconnection */
+typedef struct HostapState
+{
+	char               (*stations)[MAC_ADDR_STRING_LENGTH];
+	size_t             numOfStations, stationsSize;
+	char               *radioInfo;  /* the GET_RADIO_INFO reply; NULL if not known */
+	bool               isBaselineNeeded;  /* tracking was just enabled; the first snapshot is taken without a diff */
+	struct HostapState *snapshot;  /* the new state, while being taken over the listener rounds; NULL if none */
+	char               nextCmd[DWPAL_GENERAL_STRING_LENGTH];  /* of a snapshot: its next command ("STA-FIRST", "STA-NEXT <MAC>",
+	                                                            * "GET_RADIO_INFO"); empty once taken */
+	unsigned int       numOfTimeouts;  /* of a snapshot: the consecutive times its next command timed out with a whole round's budget */
+} HostapState;
+
+typedef struct
+{
+	char         opCode[DWPAL_OPCODE_STRING_LENGTH];
+	unsigned int windowMs;  /* the latest event per (VAP, op-code, MAC) is delivered once the window passed; 0 for no coalescing */
+	unsigned int maxPerSec;  /* the events delivered per (VAP, op-code) per second; 0 for no limit */
+} EventCoalescePolicy;
+
+/* An event held back till its coalescing window passed; the later events of the same (op-code, MAC) replace its message */
+typedef struct CoalescedEvent
+{
+	struct CoalescedEvent *next;
+	int                   policyIdx;
+	char                  MACAddress[MAC_ADDR_STRING_LENGTH];  /* empty for the events without a station MAC */
+	struct timespec       expiry;
+	char                  *msg;
+	size_t                msgLen, msgBufSize;
+} CoalescedEvent;
+
+typedef struct
+{
+	char                    opCode[DWPAL_OPCODE_STRING_LENGTH];
+	DwpalExtEventQueueStats stats;
+	unsigned int            supersedingSequence;  /* COALESCE: the queued events of the op-code that are older than this one are skipped */
+} EventQueueOpCodeStats;
+
+/* The bound of the (normal priority) events that a hostap interface queued to its callback worker. The settings are protected by
+ * 'services_lock'; the rest is updated by the producer (the listener) and by the consumer (the worker) with 'stats_mutex' locked, and
+ * the counters are stored with __atomic builtins, for dwpal_ext_hostap_event_queue_stats_get */
+typedef struct
+{
+	unsigned int             maxQueued;  /* 0 for no bound, but the worker's queue */
+	DwpalExtEventQueuePolicy policy;
+	unsigned int             sequence;  /* of the last queued event */
+	unsigned int             numOfDropsPending;  /* DROP_OLDEST: the number of the oldest queued events to be skipped */
+	unsigned int             numOfUndelivered;  /* the events in the worker's queue; the ones to be skipped included */
+	DwpalExtEventQueueStats  stats;  /* numOfQueued: the events in the worker's queue to be delivered */
+	EventQueueOpCodeStats    opCodeStats[EVENT_QUEUE_OPCODE_STATS_MAX];
+	int                      numOfOpCodeStats;  /* only added to, by the producer */
+} EventQueueBound;
+
+/* The coalescing state of a hostap interface, indexed by the policy index; used by the listener only, but for 'numOfSuppressed' */
+typedef struct
+{
+	CoalescedEvent *coalescedHead;
+	time_t         rateSecond[NUM_OF_COALESCED_OPCODES];
+	unsigned int   rateCount[NUM_OF_COALESCED_OPCODES];
+	unsigned int   numOfSuppressed[NUM_OF_COALESCED_OPCODES];  /* protected by 'stats_mutex' */
+} EventCoalesceState;
+
 typedef struct
 {
 	char                        interfaceType[DWPAL_INTERFACE_TYPE_STRING_LENGTH];
 	char                        VAPName[DWPAL_VAP_NAME_STRING_LENGTH];
 	int                         fd, fdCmdGet;
 	bool                        isConnectionEstablishNeeded;
+	bool                        isTwoWay;  /* hostap only: a single socket for both commands and events */
+	int                         hashNext;  /* the index of the next service in the same hash bucket, or (-1) */
+	char                        (*subscribedOpCodes)[DWPAL_OPCODE_STRING_LENGTH];  /* hostap only: the events to deliver; NULL for all */
+	size_t                      numOfSubscribedOpCodes;
+	int                         eventLevel;  /* hostap only: the minimal level of the events hostapd sends; 0 for hostapd's default */
+	unsigned int                backlogEvents;  /* hostap only: the events received since the event socket was last found empty */
+	unsigned int                backlogRounds;  /* hostap only: the consecutive listener rounds that left the event socket full */
+	bool                        isResyncNeeded;  /* hostap only: events may have been lost; resync once the backlog is cleared */
+	unsigned int                numOfMissedPongs;  /* hostap only: the deadlines the pending PING has passed */
+	DwpalExtHostapEventStats    eventStats;  /* hostap only: protected by 'stats_mutex' */
+	HostapState                 *state;  /* hostap only: in case of state tracking (see dwpal_ext_hostap_state_track_set); NULL otherwise */
+	EventCoalesceState          coalesce;  /* hostap only: see dwpal_ext_hostap_event_coalesce_set */
+	EventQueueBound             queueBound;  /* hostap only: see dwpal_ext_hostap_event_queue_set */
 	DwpalExtHostapEventCallback hostapEventCallback;
 	DwpalExtNlEventCallback     nlEventCallback, nlCmdGetCallback;
 	DwpalExtNlNonVendorEventCallback nlNonVendorEventCallback;
 } DwpalService;
 
+typedef enum
+{
+	EVENT_TYPE_HOSTAP = 0,
+	EVENT_TYPE_NL_VENDOR,
+	EVENT_TYPE_NL_NON_VENDOR
+} EventType;
+
 typedef struct
 {
-	int    serviceIdx;
-	char   VAPName[DWPAL_VAP_NAME_STRING_LENGTH];
-	char   opCode[64];
-	char   msg[HOSTAPD_TO_DWPAL_MSG_LENGTH];
-	size_t msgStringLen;
+	EventType     type;
+	int           serviceIdx;
+	char          VAPName[DWPAL_VAP_NAME_STRING_LENGTH];  /* nl vendor: the ifname */
+	char          opCode[64];
+	char          *msg;  /* nl vendor: the data; from eventBufferGet, released once delivered; NULL for no message */
+	size_t        msgStringLen;  /* nl vendor: the data length */
+	int           event, subevent;  /* nl vendor only */
+	struct nl_msg *nlMsg;  /* nl non-vendor only: referenced via nlmsg_get, released once delivered */
+	bool          isBounded;  /* hostap only: counted by the interface's queue bound (see hostapEventQueueBoundedPut) */
+	unsigned int  sequence;  /* hostap only: in case of 'isBounded' */
+	int           opCodeStatsIdx;  /* hostap only: in case of 'isBounded'; (-1) if the op-code has no counters */
 } EventData;
 
+/* The events of a worker are delivered high priority first; the order is kept within each priority */
+typedef enum
+{
+	EVENT_PRIORITY_HIGH = 0,
+	EVENT_PRIORITY_NORMAL,
+	NUM_OF_EVENT_PRIORITIES
+} EventPriority;
+
+/* A slot of the event queue; its sequence tells whether it is free for the producer of position 'sequence', or holds the event of
+ * position 'sequence - 1' for the consumer */
+typedef struct
+{
+	unsigned int sequence;
+	EventData    eventData;
+} EventQueueSlot;
+
+/* A bounded lock-free queue of events; the producers are the listener thread (or any other thread), and the worker thread is the
+ * single consumer */
+typedef struct
+{
+	EventQueueSlot slots[EVENT_QUEUE_SIZE];
+	unsigned int   head, tail;  /* the next position to produce, and to consume */
+} EventQueue;
+
+/* A callback worker thread, with a queue of events per priority */
+typedef struct
+{
+	EventQueue queues[NUM_OF_EVENT_PRIORITIES];
+	sem_t      sem;  /* the number of queued events, of all priorities (plus a wake-up of the stopping worker) */
+	bool       shouldStop;
+} CallbackWorker;
+
+typedef struct
+{
+	char         cmdName[DWPAL_OPCODE_STRING_LENGTH];
+	unsigned int ttlMs;
+} CmdCachePolicy;
+
+typedef struct CmdCacheEntry
+{
+	struct CmdCacheEntry *next;
+	char                 VAPName[DWPAL_VAP_NAME_STRING_LENGTH];
+	char                 cmd[DWPAL_TO_HOSTAPD_MSG_LENGTH];
+	char                 *reply;
+	size_t               replyLen, replyBufSize;
+	struct timespec      expiry;
+	bool                 isInFlight;
+	int                  numOfWaiters;
+	DWPAL_Ret            ret;
+} CmdCacheEntry;
+
+/* hostapd event received on a two-way socket while a command was waiting for its reply */
+typedef struct DeferredEvent
+{
+	struct DeferredEvent *next;
+	char                 VAPName[DWPAL_VAP_NAME_STRING_LENGTH];
+	size_t               msgLen;
+	char                 msg[];
+} DeferredEvent;
+
 typedef void *(*ThreadEntryFunc)(void *data);  /* thread entry function */
 
 
 bool isCliPrintf = false;
 
-static DwpalService *dwpalService[NUM_OF_SUPPORTED_VAPS + 1] = { [0 ... NUM_OF_SUPPORTED_VAPS ] = NULL };  /* add 1 place for NL */
-static void *context[sizeof(dwpalService) / sizeof(DwpalService *)]= { [0 ... (sizeof(dwpalService) / sizeof(DwpalService *) - 1) ] = NULL };
+/* The services' tables, indexed by the service index; all are 'numOfServices' long, and grow on demand (see servicesGrow) */
+static DwpalService **dwpalService = NULL;
+static void **context = NULL;
+static int *serviceHashHeads = NULL;  /* hash of (interfaceType, VAPName) ==> the index of the first service in the bucket, or (-1) */
+static int numOfServices = 0;
 static pthread_t listenerThreadId = (pthread_t)0;
-static int listenerThreadShouldStop = 0, listenerThreadPipeFds[2] = { 0 };
+static int listenerThreadShouldStop = 0, listenerThreadPipeFds[2] = { -1, -1 };
+static int listenerEpollFd = -1;  /* the services' event fds; kept for the process lifetime, see listenerFdAdd */
+static int listenerInotifyFd = -1;
+static time_t listenerLastPingCheck = 0, listenerLastRecoveryTime = 0;
+static bool isExternalLoop = false;  /* the listener rounds are run by the caller's loop (see dwpal_ext_dispatch), and not by a thread */
+static pthread_mutex_t dispatch_mutex = PTHREAD_MUTEX_INITIALIZER;  /* serializes the listener rounds of the external loop */
+static pthread_t dispatchThreadId = (pthread_t)0;  /* the thread running dwpal_ext_dispatch */
 static pthread_mutex_t context_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t attach_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/* The listener thread keeps running while interfaces are attached/detached; it holds 'services_lock' for read while using
+ * 'dwpalService'/'context' entries, and attach/detach take it for write while adding/removing them.
+ * Command senders look the services up with 'services_lock' held for read, and then use them with 'context_mutex' only;
+ * so the tables are resized with both held. Read locking is recursive (i.e. commands sent from the event callbacks).
+ * Lock order: 'attach_mutex' ==> 'services_lock' ==> 'context_mutex' */
+static pthread_rwlock_t services_lock = PTHREAD_RWLOCK_INITIALIZER;
+
 static pthread_mutex_t nl_cmd_mutex = PTHREAD_MUTEX_INITIALIZER;
 static unsigned char *nl_response_data = NULL;
 static size_t *nl_response_len = NULL;
 static bool nl_response_received = false;
 static bool nl_response_save_data = false;
 
-#if defined EVENT_CALLBACK_THREAD
-static int dwpal_event_handler = (-1);
-static pthread_t eventHandlerThreadId = (pthread_t)0;
-#endif
+/* Reply cache for idempotent hostapd queries; all below is protected by 'cache_mutex' */
+static pthread_mutex_t cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  cache_cond = PTHREAD_COND_INITIALIZER;
+static CmdCachePolicy  cmdCachePolicy[NUM_OF_CACHED_COMMANDS];
+static int             numOfCmdCachePolicies = 0;
+static CmdCacheEntry   *cmdCacheHead = NULL;
+static unsigned int    cmdCacheFlushGeneration = 0;  /* bumped by every flush, for the replies of the requests in flight not to be cached */
+
+/* Event coalescing/rate limiting policies; protected by 'services_lock' (set with it locked for write). A policy keeps its index
+ * (that the interfaces' counters are indexed by) once added, even if disabled */
+static EventCoalescePolicy eventCoalescePolicy[NUM_OF_COALESCED_OPCODES];
+static int                 numOfEventCoalescePolicies = 0;
+static bool                isCoalescedEventPending = false;  /* used by the listener only */
+static bool                isStateSnapshotPending = false;  /* a state snapshot is to be continued on the next round; used by the listener only */
+static struct timespec     coalescedEventNextExpiry;  /* the earliest expiry of the held events, in case of 'isCoalescedEventPending' */
+
+/* The latency-critical events, delivered ahead of the rest (see dwpal_ext_hostap_event_priority_set); protected by 'services_lock' */
+static char     highPriorityOpCodes[NUM_OF_HIGH_PRIORITY_OPCODES][DWPAL_OPCODE_STRING_LENGTH] =
+                    { "DFS-RADAR-DETECTED", "AP-CSA-FINISHED" };
+static int      numOfHighPriorityOpCodes = 2;
+static uint64_t highPriorityNlEvents = (1ULL << LTQ_NL80211_VENDOR_EVENT_RADAR_DETECTED) |
+                                       (1ULL << LTQ_NL80211_VENDOR_EVENT_CSA_RECEIVED);  /* bit per vendor sub-event */
+
+static unsigned int hostapCmdTimeoutMs = 0;  /* 0 means the deadline of the dwpal context */
+
+static bool isHostapTwoWay = false;  /* mode of the hostap interfaces to be attached */
+static int  hostapEventRcvBufSize = 0;  /* SO_RCVBUF of the hostap event sockets; 0 for the system default */
+static unsigned int hostapEventQueueLimit = UNIX_DGRAM_DEFAULT_QUEUE_LIMIT;  /* the number of events an event socket queues */
+static pthread_mutex_t stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t buffer_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char *eventBufferPoolMem = NULL;  /* allocated once, on the first event; kept for the process lifetime */
+static char *eventBufferFreeList[EVENT_BUFFER_POOL_SIZE];
+static int  numOfFreeEventBuffers = 0;
+static int  cmdServiceIdx = -1;  /* the service a command is being sent to; protected by 'context_mutex' */
+
+/* Events deferred from two-way command sends to the listener thread; all below (and the listener pipe) is protected by 'deferred_mutex' */
+static pthread_mutex_t deferred_mutex = PTHREAD_MUTEX_INITIALIZER;
+static DeferredEvent   *deferredEventHead = NULL, *deferredEventTail = NULL;
+static bool            isListenerWakeupPending = false;
+
+/* The callback workers run (and are set up/torn down) along with the listener thread; an event is queued to a worker by its VAP name */
+static CallbackWorker *callbackWorkers = NULL;
+static int            numOfCallbackWorkers = 0;  /* the running workers; 0 for calling the callbacks by the listener thread */
+static int            callbackWorkersConfigured = CALLBACK_WORKERS_DEFAULT;  /* see dwpal_ext_callback_workers_set */
+static pthread_t      callbackWorkerThreadIds[CALLBACK_WORKERS_MAX];  /* apart from the workers, for isListenerThread */
+
+/* The attributes the threads are created with (see dwpal_ext_thread_attr_set); protected by 'attach_mutex' */
+static DwpalExtThreadAttr threadAttr[DWPAL_EXT_NUM_OF_THREAD_TYPES] =
+{
+	{ 0, 0, SCHED_OTHER, 0, "dwpal_listener" },
+	{ 0, 0, SCHED_OTHER, 0, "dwpal_worker" }
+};
+
+
+static unsigned int stringHashAdd(unsigned int hash, const char *str)
+{
+	for (; *str != '\0'; str++)
+	{
+		hash = (hash ^ (unsigned char)*str) * 16777619u;  /* FNV-1a */
+	}
+
+	return hash;
+}
+
+
+static unsigned int serviceHashGet(const char *interfaceType, const char *VAPName)
+{
+	return stringHashAdd(stringHashAdd(2166136261u, interfaceType), VAPName) & (unsigned int)(numOfServices - 1);
+}
 
 
+/* Called with 'services_lock' locked (or by the attach/detach, with 'attach_mutex' locked) */
 static DWPAL_Ret interfaceIndexGet(char *interfaceType, char *VAPName, int *idx)
 {
-	int    i;
-	size_t numOfServices = sizeof(dwpalService) / sizeof(DwpalService *);
+	int i;
 
 	*idx = 0;
 
-	for (i=0; i < (int)numOfServices; i++)
+	if (numOfServices == 0)
 	{
-		if (dwpalService[i] == NULL)
-			continue;
+		return DWPAL_INTERFACE_IS_DOWN;
+	}
 
+	for (i = serviceHashHeads[serviceHashGet(interfaceType, VAPName)]; i != (-1); i = dwpalService[i]->hashNext)
+	{
 		if ( (!strncmp(interfaceType, dwpalService[i]->interfaceType, DWPAL_INTERFACE_TYPE_STRING_LENGTH)) &&
 		     (!strncmp(VAPName, dwpalService[i]->VAPName, DWPAL_VAP_NAME_STRING_LENGTH)) )
 		{
@@ -104,10 +371,71 @@ static DWPAL_Ret interfaceIndexGet(char *interfaceType, char *VAPName, int *idx)
 }
 
 
+/* Double the services' tables (the services keep their indexes); called with 'services_lock' locked for write */
+static DWPAL_Ret servicesGrow(void)
+{
+	int          i, newNumOfServices = (numOfServices == 0) ? SERVICES_INITIAL_SIZE : (numOfServices * 2);
+	unsigned int bucket;
+	DwpalService **newDwpalService = (DwpalService **)calloc((size_t)newNumOfServices, sizeof(DwpalService *));
+	void         **newContext = (void **)calloc((size_t)newNumOfServices, sizeof(void *));
+	int          *newServiceHashHeads = (int *)malloc((size_t)newNumOfServices * sizeof(int));
+
+	if ( (newDwpalService == NULL) || (newContext == NULL) || (newServiceHashHeads == NULL) )
+	{
+		console_printf("%s; malloc (newNumOfServices= %d) failed ==> Abort!\n", __FUNCTION__, newNumOfServices);
+		free((void *)newDwpalService);
+		free((void *)newContext);
+		free((void *)newServiceHashHeads);
+		return DWPAL_FAILURE;
+	}
+
+	/* Command senders use the tables with 'context_mutex' only */
+	pthread_mutex_lock(&context_mutex);
+
+	if (numOfServices > 0)
+	{
+		memcpy(newDwpalService, dwpalService, (size_t)numOfServices * sizeof(DwpalService *));
+		memcpy(newContext, context, (size_t)numOfServices * sizeof(void *));
+	}
+
+	free((void *)dwpalService);
+	free((void *)context);
+	free((void *)serviceHashHeads);
+
+	dwpalService = newDwpalService;
+	context = newContext;
+	serviceHashHeads = newServiceHashHeads;
+	numOfServices = newNumOfServices;
+
+	/* The number of buckets follows the size of the tables */
+	for (i=0; i < numOfServices; i++)
+	{
+		serviceHashHeads[i] = (-1);
+	}
+
+	for (i=0; i < numOfServices; i++)
+	{
+		if (dwpalService[i] != NULL)
+		{
+			bucket = serviceHashGet(dwpalService[i]->interfaceType, dwpalService[i]->VAPName);
+			dwpalService[i]->hashNext = serviceHashHeads[bucket];
+			serviceHashHeads[bucket] = i;
+		}
+	}
+
+	pthread_mutex_unlock(&context_mutex);
+
+	console_printf("%s; numOfServices= %d\n", __FUNCTION__, numOfServices);
+
+	return DWPAL_SUCCESS;
+}
+
+
+/* Called with 'services_lock' locked for write */
 static DWPAL_Ret interfaceIndexCreate(char *interfaceType, char *VAPName, int *idx)
 {
-	int    i;
-	size_t numOfServices = sizeof(dwpalService) / sizeof(DwpalService *);
+	int          i;
+	unsigned int bucket;
 
 	*idx = 0;
 
@@ -127,42 +455,86 @@ static DWPAL_Ret interfaceIndexCreate(char *interfaceType, char *VAPName, int *i
 		}
 	}
 
-	/* Getting here means that the interface does NOT exist ==> create it! */
-	for (i=0; i < (int)numOfServices; i++)
+	/* Getting here means that the interface does NOT exist ==> create it in the first empty entry */
+	for (i=0; i < numOfServices; i++)
 	{
 		if (dwpalService[i] == NULL)
-		{  /* First empty entry ==> use it */
-			dwpalService[i] = (DwpalService *)malloc(sizeof(DwpalService));
-			if (dwpalService[i] == NULL)
-			{
-				console_printf("%s; malloc failed ==> Abort!\n", __FUNCTION__);
-				return DWPAL_FAILURE;
-			}
-
-			strcpy_s(dwpalService[i]->interfaceType, sizeof(dwpalService[i]->interfaceType), interfaceType);
-			strcpy_s(dwpalService[i]->VAPName, sizeof(dwpalService[i]->VAPName), VAPName);
+		{
+			break;
+		}
+	}
 
-			*idx = i;
-			return DWPAL_SUCCESS;
+	if (i == numOfServices)
+	{  /* all entries are in use (the new first empty one will be the first of the added ones) */
+		if (servicesGrow() == DWPAL_FAILURE)
+		{
+			console_printf("%s; number of interfaces (%d) reached its limit ==> Abort!\n", __FUNCTION__, i);
+			return DWPAL_FAILURE;
 		}
 	}
 
-	console_printf("%s; number of interfaces (%d) reached its limit ==> Abort!\n", __FUNCTION__, i);
+	dwpalService[i] = (DwpalService *)malloc(sizeof(DwpalService));
+	if (dwpalService[i] == NULL)
+	{
+		console_printf("%s; malloc failed ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
 
-	return DWPAL_FAILURE;
+	strcpy_s(dwpalService[i]->interfaceType, sizeof(dwpalService[i]->interfaceType), interfaceType);
+	strcpy_s(dwpalService[i]->VAPName, sizeof(dwpalService[i]->VAPName), VAPName);
+	dwpalService[i]->fd = dwpalService[i]->fdCmdGet = -1;
+	dwpalService[i]->isConnectionEstablishNeeded = false;
+	dwpalService[i]->isTwoWay = isHostapTwoWay;  /* kept for the lifetime of the interface, recoveries included */
+	dwpalService[i]->subscribedOpCodes = NULL;
+	dwpalService[i]->numOfSubscribedOpCodes = 0;
+	dwpalService[i]->eventLevel = 0;
+	dwpalService[i]->backlogEvents = 0;
+	dwpalService[i]->backlogRounds = 0;
+	dwpalService[i]->isResyncNeeded = false;
+	dwpalService[i]->numOfMissedPongs = 0;
+	memset(&dwpalService[i]->eventStats, 0, sizeof(dwpalService[i]->eventStats));
+	dwpalService[i]->state = NULL;
+	memset(&dwpalService[i]->coalesce, 0, sizeof(dwpalService[i]->coalesce));
+	memset(&dwpalService[i]->queueBound, 0, sizeof(dwpalService[i]->queueBound));
+	dwpalService[i]->hostapEventCallback = NULL;
+	dwpalService[i]->nlEventCallback = dwpalService[i]->nlCmdGetCallback = NULL;
+	dwpalService[i]->nlNonVendorEventCallback = NULL;
+
+	bucket = serviceHashGet(interfaceType, VAPName);
+	dwpalService[i]->hashNext = serviceHashHeads[bucket];
+	serviceHashHeads[bucket] = i;
+
+	*idx = i;
+	return DWPAL_SUCCESS;
 }
 
 
-static bool isAnyInterfaceActive(void)
+static void hostapStateFree(HostapState *state)
+{
+	if (state == NULL)
+	{
+		return;
+	}
+
+	hostapStateFree(state->snapshot);
+	free((void *)state->stations);
+	free((void *)state->radioInfo);
+	free((void *)state);
+}
+
+
+static bool hostapStationIsFound(HostapState *state, const char *MACAddress, size_t *stationIdx /*OUT*/)
 {
-	int i, numOfServices = sizeof(dwpalService) / sizeof(DwpalService *);
+	size_t i;
 
-	/* check if there are active interfaces */
-	for (i=0; i < numOfServices; i++)
+	for (i=0; i < state->numOfStations; i++)
 	{
-		/* In case that there is a valid context, break! */
-		if (dwpalService[i] != NULL)
+		if (!strncmp(state->stations[i], MACAddress, MAC_ADDR_STRING_LENGTH - 1))
 		{
+			if (stationIdx != NULL)
+			{
+				*stationIdx = i;
+			}
 			return true;
 		}
 	}
@@ -171,1418 +543,4707 @@ static bool isAnyInterfaceActive(void)
 }
 
 
-#if defined EVENT_CALLBACK_THREAD
-static DWPAL_Ret socket_data_send(char *socketPrefixName, char *data, size_t size)
+static void hostapStationAdd(HostapState *state, const char *MACAddress)
 {
-    int                fd = -1, byte;
-	struct sockaddr_un un;
-	size_t             len;
-	char               socketName[SOCKET_NAME_LENGTH] = "\0";
-	pid_t              pid = getpid();
-
-	//console_printf("%s Entry; socketPrefixName= '%s', size= %d\n", __FUNCTION__, socketPrefixName, size);
+	if (hostapStationIsFound(state, MACAddress, NULL))
+	{
+		return;
+	}
 
-	/* create a UNIX domain stream socket */
-	if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+	if (state->numOfStations == state->stationsSize)
 	{
-		console_printf("%s; create socket fail; pid= %d; errno= %d ('%s')\n", __FUNCTION__, pid, errno, strerror(errno));
-		return DWPAL_FAILURE;
-    }
+		size_t newSize = (state->stationsSize == 0) ? NUM_OF_SUPPORTED_VAPS : (state->stationsSize * 2);
+		char   (*newStations)[MAC_ADDR_STRING_LENGTH] = realloc(state->stations, newSize * MAC_ADDR_STRING_LENGTH);
+
+		if (newStations == NULL)
+		{
+			console_printf("%s; realloc failed ==> station '%s' is not tracked\n", __FUNCTION__, MACAddress);
+			return;
+		}
 
-	/* fill socket address structure with server's address */
-	memset(&un, 0, sizeof(un));
-	un.sun_family = AF_UNIX;
+		state->stations = newStations;
+		state->stationsSize = newSize;
+	}
+
+	strncpy_s(state->stations[state->numOfStations], MAC_ADDR_STRING_LENGTH, MACAddress, MAC_ADDR_STRING_LENGTH - 1);
+	state->numOfStations++;
+}
 
-	snprintf_s(socketName, sizeof(socketName), "%s_%d", socketPrefixName, pid);
-	strcpy_s(un.sun_path, sizeof(un.sun_path), socketName);
-	len = offsetof(struct sockaddr_un, sun_path) + strnlen_s(socketName, sizeof(socketName));
 
-	if (connect(fd, (struct sockaddr *)&un, len) < 0)
-	{
-		console_printf("%s; connect() fail; pid= %d; errno= %d ('%s')\n",
-		       __FUNCTION__, pid, errno, strerror(errno));
+static void hostapStationRemove(HostapState *state, const char *MACAddress)
+{
+	size_t i;
 
-		if (close(fd) == (-1))
+	if (hostapStationIsFound(state, MACAddress, &i))
+	{  /* the order does not matter; move the last one in */
+		state->numOfStations--;
+		if (i != state->numOfStations)
 		{
-			console_printf("%s; close() fail; pid= %d; errno= %d ('%s')\n",
-				   __FUNCTION__, pid, errno, strerror(errno));
+			memcpy(state->stations[i], state->stations[state->numOfStations], MAC_ADDR_STRING_LENGTH);
 		}
+	}
+}
 
-		return DWPAL_FAILURE;
+
+/* Keep the tracked station list up to date by the station events (i.e. "<3>AP-STA-CONNECTED wlan0 24:77:03:80:5d:90 ...") */
+static void hostapStateEventUpdate(HostapState *state, const char *opCode, const char *msg)
+{
+	const char *MACAddress;
+	bool       isConnected = !strncmp(opCode, "AP-STA-CONNECTED", sizeof("AP-STA-CONNECTED"));
+
+	if ( (!isConnected) && (strncmp(opCode, "AP-STA-DISCONNECTED", sizeof("AP-STA-DISCONNECTED"))) )
+	{
+		return;
 	}
 
-	if ((byte = write(fd, data, size)) == -1)
+	/* Skip the op-code and the VAP name */
+	if ( ((MACAddress = strchr(msg, ' ')) == NULL) || ((MACAddress = strchr(MACAddress + 1, ' ')) == NULL) )
 	{
-		console_printf("%s; write() fail; pid= %d; errno= %d ('%s')\n",
-		       __FUNCTION__, pid, errno, strerror(errno));
+		return;
+	}
+	MACAddress++;
+
+	if (isConnected)
+	{
+		hostapStationAdd(state, MACAddress);
+	}
+	else
+	{
+		hostapStationRemove(state, MACAddress);
 
-		if (close(fd) == (-1))
+		/* STA-NEXT of a station that is gone fails; the snapshot's station list is walked again (the found ones are kept) */
+		if ( (!strncmp(state->nextCmd, "STA-NEXT ", 9)) && (!strncmp(state->nextCmd + 9, MACAddress, MAC_ADDR_STRING_LENGTH - 1)) )
 		{
-			console_printf("%s; close() fail; pid= %d; errno= %d ('%s')\n",
-				   __FUNCTION__, pid, errno, strerror(errno));
+			strcpy_s(state->nextCmd, sizeof(state->nextCmd), "STA-FIRST");
 		}
-
-		return DWPAL_FAILURE;
 	}
 
-	if (close(fd) == (-1))
+	/* The snapshot being taken may have already passed the station */
+	if (state->snapshot != NULL)
 	{
-		console_printf("%s; close() fail; pid= %d; errno= %d ('%s')\n",
-		       __FUNCTION__, pid, errno, strerror(errno));
+		hostapStateEventUpdate(state->snapshot, opCode, msg);
 	}
+}
 
-	return DWPAL_SUCCESS;
+
+static void coalescedEventsFree(CoalescedEvent *coalescedEvent)
+{
+	while (coalescedEvent != NULL)
+	{
+		CoalescedEvent *next = coalescedEvent->next;
+
+		free((void *)coalescedEvent->msg);
+		free((void *)coalescedEvent);
+		coalescedEvent = next;
+	}
 }
-#endif
 
 
-static void interfacesRecoverIfNeeded(void)
+/* Called with 'services_lock' locked for write */
+static void interfaceIndexRemove(int idx)
 {
-	int  i, numOfServices = sizeof(dwpalService) / sizeof(DwpalService *);
-	DWPAL_Ret ret;
+	int *p2idx = &serviceHashHeads[serviceHashGet(dwpalService[idx]->interfaceType, dwpalService[idx]->VAPName)];
+
+	while (*p2idx != idx)
+	{
+		p2idx = &dwpalService[*p2idx]->hashNext;
+	}
+	*p2idx = dwpalService[idx]->hashNext;
+
+	free((void *)dwpalService[idx]->subscribedOpCodes);
+	hostapStateFree(dwpalService[idx]->state);
+	coalescedEventsFree(dwpalService[idx]->coalesce.coalescedHead);
+	free((void *)dwpalService[idx]);
+	dwpalService[idx] = NULL;
+}
 
-	//console_printf("%s Entry\n", __FUNCTION__);
 
+static bool isAnyInterfaceActive(void)
+{
+	int i;
+
+	/* check if there are active interfaces */
 	for (i=0; i < numOfServices; i++)
 	{
-		/* In case that there is no valid context, continue... */
-		if (dwpalService[i] == NULL)
+		/* In case that there is a valid context, break! */
+		if (dwpalService[i] != NULL)
 		{
-			continue;
+			return true;
 		}
+	}
 
-		/* In case of recovery needed, try recover; in case of interface init, try to establish the connection */
-		if ( (!strncmp(dwpalService[i]->interfaceType, "hostap", 7)) &&
-		     (dwpalService[i]->isConnectionEstablishNeeded == true) )
-		{
-			pthread_mutex_lock(&context_mutex);
-			ret = dwpal_hostap_interface_attach(&context[i] /*OUT*/, dwpalService[i]->VAPName, NULL /*use one-way interface*/);
-			pthread_mutex_unlock(&context_mutex);
+	return false;
+}
 
-			if (ret == DWPAL_SUCCESS)
-			{
-				console_printf("%s; VAPName= '%s' interface recovered successfully!\n", __FUNCTION__, dwpalService[i]->VAPName);
-				dwpalService[i]->isConnectionEstablishNeeded = false;
 
-#if defined EVENT_CALLBACK_THREAD
-				{
-					EventData eventData;
-					eventData.serviceIdx = i;
-					strcpy_s(eventData.VAPName, sizeof(eventData.VAPName), dwpalService[i]->VAPName);
-					strcpy_s(eventData.opCode, sizeof(eventData.opCode), "INTERFACE_RECONNECTED_OK");
-					memset(eventData.msg, '\0', sizeof(eventData.msg));
-					eventData.msgStringLen = sizeof("INTERFACE_RECONNECTED_OK");
-
-					/* Notify via the callback that interface recovered successfully */
-					if (socket_data_send(EVENT_HANDLER_SOCKET, (char *)&eventData, sizeof(EventData)) == DWPAL_FAILURE)
-					{
-						console_printf("%s; socket_data_send failed ==> cont...\n", __FUNCTION__);
-					}
-				}
-#else
-				/* Notify via the callback that interface recovered successfully */
-				dwpalService[i]->hostapEventCallback(dwpalService[i]->VAPName, "INTERFACE_RECONNECTED_OK", NULL, 0);
-#endif
-			}
-		}
-	}
+/* The epoll event data: the tag in the low half, and the fd in the high half, so that a stale readiness (of an fd that was
+ * removed between epoll_wait() and its handling, and its tag re-used) is found out */
+static uint64_t listenerEpollDataGet(unsigned int tag, int fd)
+{
+	return ((uint64_t)(unsigned int)fd << 32) | tag;
 }
 
 
-static void interfacesPingCheck(void)
+static void listenerEpollFdAdd(unsigned int tag, int fd)
 {
-	int    i, numOfServices = sizeof(dwpalService) / sizeof(DwpalService *);
-	char   reply[HOSTAPD_TO_DWPAL_SHORT_REPLY_LENGTH];
-	size_t replyLen = sizeof(reply) - 1;
-
-	//console_printf("%s Entry\n", __FUNCTION__);
+	struct epoll_event event;
 
-	for (i=0; i < numOfServices; i++)
+	if (listenerEpollFd < 0)
 	{
-		/* In case that there is no valid context, continue... */
-		if (context[i] == NULL)
+		listenerEpollFd = epoll_create1(EPOLL_CLOEXEC);
+		if (listenerEpollFd < 0)
 		{
-			continue;
+			console_printf("%s; epoll_create1 ERROR (errno= %d) ==> Abort!\n", __FUNCTION__, errno);
+			return;
 		}
+	}
 
-		if (!strncmp(dwpalService[i]->interfaceType, "hostap", sizeof("hostap") - 1))
-		{
-			if (dwpalService[i]->fd > 0)
-			{
-				/* check if interface that should exist, still exists */
-				if (dwpal_ext_hostap_cmd_send(dwpalService[i]->VAPName, "PING", NULL, reply, &replyLen) == DWPAL_FAILURE)
-				{
-					console_printf("%s; VAPName= '%s' interface needs to be recovered\n", __FUNCTION__, dwpalService[i]->VAPName);
-
-					dwpalService[i]->isConnectionEstablishNeeded = true;
-					dwpalService[i]->fd = -1;
-
-					pthread_mutex_lock(&context_mutex);
-					/* Close 'wpaCtrlPtr', and free 'context' */
-					if (context[i] != NULL && dwpal_hostap_interface_detach(&context[i]) == DWPAL_FAILURE)
-					{
-						console_printf("%s; dwpal_hostap_interface_detach (VAPName= '%s') returned ERROR ==> cont...\n", __FUNCTION__, dwpalService[i]->VAPName);
-					}
-					pthread_mutex_unlock(&context_mutex);
-				}
-			}
-		}
+	event.events = EPOLLIN;
+	event.data.u64 = listenerEpollDataGet(tag, fd);
+
+	if (epoll_ctl(listenerEpollFd, EPOLL_CTL_ADD, fd, &event) < 0)
+	{
+		console_printf("%s; epoll_ctl (fd= %d) ERROR (errno= %d) ==> cont...\n", __FUNCTION__, fd, errno);
 	}
 }
 
 
-#if defined EVENT_CALLBACK_THREAD
-static void *eventHandlerThreadStart(void *temp)
+static void listenerEpollFdRemove(int fd)
 {
-	int                clientfd = -1, byte;
-	size_t             len;
-	char               rcv_buf[sizeof(EventData)];
-	EventData          *eventData = NULL;
-	struct sockaddr_un un;
+	if ( (listenerEpollFd >= 0) && (epoll_ctl(listenerEpollFd, EPOLL_CTL_DEL, fd, NULL) < 0) )
+	{
+		console_printf("%s; epoll_ctl (fd= %d) ERROR (errno= %d) ==> cont...\n", __FUNCTION__, fd, errno);
+	}
+}
 
-	(void)temp;
 
-	console_printf("%s Entry\n", __FUNCTION__);
+/* Add the event fd of a service into the listener thread, once its context is set; called with 'services_lock' locked for write,
+ * or by the listener thread itself (the only one setting contexts while holding it for read) */
+static void listenerFdAdd(int idx)
+{
+	DWPAL_Ret ret;
 
-	if (dwpal_event_handler == -1)
+	if (!strncmp(dwpalService[idx]->interfaceType, "hostap", sizeof("hostap")))
 	{
-		console_printf("%s; dwpal_event_handler not valid ==> Abort!\n", __FUNCTION__);
-		return NULL;
+		ret = dwpal_hostap_event_fd_get(context[idx], &dwpalService[idx]->fd /*OUT*/);
+	}
+	else
+	{
+		ret = dwpal_driver_nl_fd_get(context[idx], &dwpalService[idx]->fd /*OUT*/, &dwpalService[idx]->fdCmdGet /*OUT*/);
 	}
 
-	/* Receive the msg */
-	while (true)
+	if ( (ret == DWPAL_FAILURE) || (dwpalService[idx]->fd <= 0) )
 	{
-		/* Handle the COMMAND_SOCKET */
-		len = sizeof(un);
-		if ((clientfd = accept(dwpal_event_handler, (struct sockaddr *)&un, &len)) < 0)
-		{ // wait for client to connect to me (server)
-			console_printf("%s; ERROR: accept() received; clientfd= %d; errno= %d ('%s') ==> cont...\n", __FUNCTION__, clientfd, errno, strerror(errno));
-			continue;
-		}
+		console_printf("%s; no event fd (VAPName= '%s') ==> cont...\n", __FUNCTION__, dwpalService[idx]->VAPName);
+		dwpalService[idx]->fd = -1;
+		return;
+	}
 
-		memset(rcv_buf, '\0', sizeof(rcv_buf));
+	listenerEpollFdAdd((unsigned int)(idx + LISTENER_EPOLL_SERVICE_BASE), dwpalService[idx]->fd);
+}
 
-		if ((byte = read(clientfd, rcv_buf, sizeof(rcv_buf))) == -1)
-		{   // wait for client to write/send data to me (server)
-			console_printf("%s; read() fail; errno= %d ('%s')\n", __FUNCTION__, errno, strerror(errno));
 
-			if (close(clientfd) == (-1))
-			{
-				console_printf("%s; close() fail; clientfd= %d; errno= %d ('%s')\n", __FUNCTION__, clientfd, errno, strerror(errno));
-			}
-			continue;
-		}
+/* Take the event fd of a service out of the listener thread, before its context is reset (and the fd is closed) */
+static void listenerFdRemove(int idx)
+{
+	if ( (dwpalService[idx] == NULL) || (dwpalService[idx]->fd <= 0) )
+	{
+		return;
+	}
 
-		if (close(clientfd) == (-1))
+	listenerEpollFdRemove(dwpalService[idx]->fd);
+	dwpalService[idx]->fd = -1;
+}
+
+
+/* Wake the listener thread up, without stopping it */
+static void listenerThreadWakeUp(void)
+{
+	pthread_mutex_lock(&deferred_mutex);
+	if ( (!isListenerWakeupPending) && (listenerThreadPipeFds[1] != -1) )
+	{
+		if (write(listenerThreadPipeFds[1], "W", 1) < 0)
 		{
-			console_printf("%s; close() fail; clientfd= %d; errno= %d ('%s')\n", __FUNCTION__, clientfd, errno, strerror(errno));
+			console_printf("%s; write to listenerThreadPipeFds[1] FAILED (errno= %d)\n", __FUNCTION__, errno);
 		}
-
-		if ( (byte > (int)sizeof(EventData)) || (byte < 1) )
+		else
 		{
-			console_printf("%s; ERROR: read() returned buffer size (%d) out of range (1 <-> %d) ==> cont...\n", __FUNCTION__, byte, sizeof(EventData));
-			continue;
+			isListenerWakeupPending = true;
 		}
-
-		eventData = (EventData *)rcv_buf;
-
-		dwpalService[eventData->serviceIdx]->hostapEventCallback(eventData->VAPName, eventData->opCode, eventData->msg, eventData->msgStringLen);
 	}
-
-	return NULL;
+	pthread_mutex_unlock(&deferred_mutex);
 }
-#endif
 
 
-static void *listenerThreadStart(void *temp)
+/* Get a buffer for an event of 'size' bytes; the pool's buffers are reused, so that steady-state event handling does not allocate.
+ * Larger events (and events received while the pool is used up) get an allocated buffer instead. Released via eventBufferRelease */
+static char *eventBufferGet(size_t size)
 {
-	int     i, highestValFD, ret, numOfServices = sizeof(dwpalService) / sizeof(DwpalService *);
-	bool    isInterfacesPingCheck;
-	char    *msg;
-	size_t  msgLen, msgStringLen;
-	fd_set  rfds;
-	char    opCode[64];
-	struct  timeval tv;
-	time_t	last_ping_check = time(NULL);
-	time_t	last_recovery_time = last_ping_check;
-	time_t  current_time;
-
-	(void)temp;
-
-	console_printf("%s Entry\n", __FUNCTION__);
+	char *buf = NULL;
+	int  i;
 
-	/* Receive the msg */
-	while (!listenerThreadShouldStop)
+	if (size <= HOSTAPD_TO_DWPAL_MSG_LENGTH)
 	{
-		FD_ZERO(&rfds);
-
-		FD_SET(listenerThreadPipeFds[0], &rfds);
-		highestValFD = listenerThreadPipeFds[0];
+		pthread_mutex_lock(&buffer_pool_mutex);
 
-		for (i=0; i < numOfServices; i++)
+		if (eventBufferPoolMem == NULL)
 		{
-			/* In case that there is no valid context, or no valid service, continue... */
-			if ( (context[i] == NULL) || (dwpalService[i] == NULL) )
-			{
-				continue;
-			}
-
-			if (!strncmp(dwpalService[i]->interfaceType, "hostap", 7))
-			{
-				if (dwpal_hostap_event_fd_get(context[i], &dwpalService[i]->fd) == DWPAL_FAILURE)
-				{
-					/*console_printf("%s; dwpal_hostap_event_fd_get returned error ==> cont. (VAPName= '%s')\n",
-					       __FUNCTION__, dwpalService[i]->VAPName);*/
-					continue;
-				}
-
-				if (dwpalService[i]->fd > 0)
-				{
-					FD_SET(dwpalService[i]->fd, &rfds);
-					highestValFD = (dwpalService[i]->fd > highestValFD)? dwpalService[i]->fd : highestValFD;  /* find the highest value fd */
-				}
-			}
-			else if (!strncmp(dwpalService[i]->interfaceType, "Driver", 7))
+			eventBufferPoolMem = (char *)malloc(EVENT_BUFFER_POOL_SIZE * HOSTAPD_TO_DWPAL_MSG_LENGTH);
+			if (eventBufferPoolMem != NULL)
 			{
-				if (dwpal_driver_nl_fd_get(context[i], &dwpalService[i]->fd, &dwpalService[i]->fdCmdGet) == DWPAL_FAILURE)
+				for (i=0; i < EVENT_BUFFER_POOL_SIZE; i++)
 				{
-					/*console_printf("%s; dwpal_driver_nl_fd_get returned error ==> cont. (VAPName= '%s')\n",
-					       __FUNCTION__, dwpalService[i].VAPName);*/
-					continue;
-				}
-
-				if (dwpalService[i]->fd > 0)
-				{
-					FD_SET(dwpalService[i]->fd, &rfds);
-					highestValFD = (dwpalService[i]->fd > highestValFD)? dwpalService[i]->fd : highestValFD;  /* find the highest value fd */
+					eventBufferFreeList[i] = eventBufferPoolMem + (size_t)i * HOSTAPD_TO_DWPAL_MSG_LENGTH;
 				}
+				numOfFreeEventBuffers = EVENT_BUFFER_POOL_SIZE;
 			}
 		}
 
-		//console_printf("%s; highestValFD= %d\n", __FUNCTION__, highestValFD);
-
-		/* Interval of time in which the select() will be released */
-		tv.tv_sec = 1;
-		tv.tv_usec = 0;
-		isInterfacesPingCheck = false;
-
-		/* In case that no active hostap is available, highestValFD is '0' and we'll loop out according to tv values */
-		ret = select(highestValFD + 1, &rfds, NULL, NULL, &tv);
-		if (ret < 0)
+		if (numOfFreeEventBuffers > 0)
 		{
-			console_printf("%s; select() return value= %d ==> cont...; errno= %d ('%s')\n", __FUNCTION__, ret, errno, strerror(errno));
-			continue;
+			buf = eventBufferFreeList[--numOfFreeEventBuffers];
 		}
 
-		if (FD_ISSET(listenerThreadPipeFds[0], &rfds))
-		{
-			char pipedMsg[16];
+		pthread_mutex_unlock(&buffer_pool_mutex);
+	}
 
-			console_printf("%s; received message from main thread => shutting down\n", __FUNCTION__);
+	if (buf == NULL)
+	{
+		buf = (char *)malloc(size);
+	}
 
-			if ((ret = read(listenerThreadPipeFds[0], pipedMsg, sizeof(pipedMsg))) < 0)
-			{
-				console_printf("%s; read() return value= %d ==> cont...; errno= %d ('%s')\n", __FUNCTION__, ret, errno, strerror(errno));
-			}
-			break;
-		}
+	return buf;
+}
 
-		for (i=0; i < numOfServices; i++)
-		{
-			/* In case that there is no valid context, or no valid service, continue... */
-			if ( (context[i] == NULL) || (dwpalService[i] == NULL) )
-			{
-				continue;
-			}
 
-			if (!strncmp(dwpalService[i]->interfaceType, "hostap", 7))
-			{
-				if (dwpalService[i]->fd > 0)
-				{
-					if (FD_ISSET(dwpalService[i]->fd, &rfds))
-					{
-						/*console_printf("%s; event received; interfaceType= '%s', VAPName= '%s'\n",
-						       __FUNCTION__, dwpalService[i]->interfaceType, dwpalService[i]->VAPName);*/
-
-						msg = (char *)malloc((size_t)(HOSTAPD_TO_DWPAL_MSG_LENGTH * sizeof(char)));
-						if (msg == NULL)
-						{
-							console_printf("%s; invalid input ('msg') parameter ==> cont...\n", __FUNCTION__);
-							continue;
-						}
-
-						memset(msg, 0, HOSTAPD_TO_DWPAL_MSG_LENGTH * sizeof(char));  /* Clear the output buffer */
-						memset(opCode, 0, sizeof(opCode));
-						msgLen = HOSTAPD_TO_DWPAL_MSG_LENGTH - 1;  //was "msgLen = HOSTAPD_TO_DWPAL_MSG_LENGTH;"
-
-						if (dwpal_hostap_event_get(context[i], msg /*OUT*/, &msgLen /*IN/OUT*/, opCode /*OUT*/) == DWPAL_FAILURE)
-						{
-							console_printf("%s; dwpal_hostap_event_get ERROR; VAPName= '%s', msgLen= %d\n",
-							       __FUNCTION__, dwpalService[i]->VAPName, msgLen);
-
-							/* Trigger the recovery check/perform immediately */
-							isInterfacesPingCheck = true;
-						}
-						else
-						{
-							//console_printf("%s; msgLen= %d, msg= '%s'\n", __FUNCTION__, msgLen, msg);
-//strcpy(msg, "<3>AP-STA-CONNECTED wlan0 24:77:03:80:5d:90 SignalStrength=-49 SupportedRates=2 4 11 22 12 18 24 36 48 72 96 108 HT_CAP=107E HT_MCS=FF FF FF 00 00 00 00 00 00 00 C2 01 01 00 00 00 VHT_CAP=03807122 VHT_MCS=FFFA 0000 FFFA 0000 btm_supported=1 nr_enabled=0 non_pref_chan=81:200:1:7 non_pref_chan=81:100:2:9 non_pref_chan=81:200:1:7 non_pref_chan=81:100:2:5 cell_capa=1 assoc_req=00003A01000A1B0E04606C722002E833000A1B0E0460C04331060200000E746573745F737369645F69736172010882848B960C12182432043048606C30140100000FAC040100000FAC040100000FAC020000DD070050F2020001002D1AEF1903FFFFFF00000000000000000000000000000018040109007F080000000000000040BF0CB059C103EAFF1C02EAFF1C02C70122");
-//strcpy(msg, "<3>AP-STA-DISCONNECTED wlan0 14:d6:4d:ac:36:70");
-//strcpy(opCode, "AP-STA-CONNECTED");
+static void eventBufferRelease(char *buf)
+{
+	if ( (eventBufferPoolMem != NULL) && (buf >= eventBufferPoolMem) &&
+	     (buf < eventBufferPoolMem + EVENT_BUFFER_POOL_SIZE * HOSTAPD_TO_DWPAL_MSG_LENGTH) )
+	{
+		pthread_mutex_lock(&buffer_pool_mutex);
+		eventBufferFreeList[numOfFreeEventBuffers++] = buf;
+		pthread_mutex_unlock(&buffer_pool_mutex);
+	}
+	else
+	{
+		free((void *)buf);
+	}
+}
 
-							msgStringLen = strnlen_s(msg, HOSTAPD_TO_DWPAL_MSG_LENGTH);
-							//console_printf("%s; opCode= '%s', msg= '%s'\n", __FUNCTION__, opCode, msg);
-							if (strncmp(opCode, "", 1))
-							{
-#if defined EVENT_CALLBACK_THREAD
-								EventData eventData;
-								eventData.serviceIdx = i;
-								strcpy_s(eventData.VAPName, sizeof(eventData.VAPName), dwpalService[i]->VAPName);
-								strcpy_s(eventData.opCode, sizeof(eventData.opCode), opCode);
-								strcpy_s(eventData.msg, sizeof(eventData.msg), msg);
-								eventData.msgStringLen = msgStringLen;
-
-								/* Send the event via the callback */
-								if (socket_data_send(EVENT_HANDLER_SOCKET, (char *)&eventData, sizeof(EventData)) == DWPAL_FAILURE)
-								{
-									console_printf("%s; socket_data_send failed ==> cont...\n", __FUNCTION__);
-								}
-#else
-								if (dwpalService[i]->hostapEventCallback != NULL)
-								{
-									dwpalService[i]->hostapEventCallback(dwpalService[i]->VAPName, opCode, msg, msgStringLen);
-								}
-#endif
-							}
-						}
 
-						free((void *)msg);
-					}
-				}
-			}
-			else if (!strncmp(dwpalService[i]->interfaceType, "Driver", 7))
-			{
-				if ( (dwpalService[i]->fd > 0) && (FD_ISSET(dwpalService[i]->fd, &rfds)) )
-				{
-					console_printf("%s; event received; interfaceType= '%s', VAPName= '%s'\n",
-						   __FUNCTION__, dwpalService[i]->interfaceType, dwpalService[i]->VAPName);
+static void eventDataRelease(EventData *eventData)
+{
+	if (eventData->msg != NULL)
+	{
+		eventBufferRelease(eventData->msg);
+	}
 
-					if (dwpal_driver_nl_msg_get(context[i], DWPAL_NL_UNSOLICITED_EVENT, dwpalService[i]->nlEventCallback, dwpalService[i]->nlNonVendorEventCallback) == DWPAL_FAILURE)
-					{
-						console_printf("%s; dwpal_driver_nl_msg_get ERROR\n", __FUNCTION__);
-					}
-				}
-			}
-		}
+	if (eventData->nlMsg != NULL)
+	{
+		nlmsg_free(eventData->nlMsg);
+	}
+}
 
-		current_time = time(NULL);
-		if ( (isInterfacesPingCheck) || ((current_time - last_ping_check) >= PING_CHECK_TIME) )
+
+/* Reset the event queue of a worker, releasing the events left in it; called while neither its producers nor the worker are running */
+static void eventQueueReset(CallbackWorker *worker)
+{
+	unsigned int i;
+	EventQueue   *queue;
+
+	for (queue = worker->queues; queue < &worker->queues[NUM_OF_EVENT_PRIORITIES]; queue++)
+	{
+		for (i=queue->tail; i != queue->head; i++)
 		{
-			last_ping_check = current_time;
-			interfacesPingCheck();
+			eventDataRelease(&queue->slots[i & (EVENT_QUEUE_SIZE - 1)].eventData);
 		}
 
-		if (current_time - last_recovery_time >= RECOVERY_RETRY_TIME)
+		for (i=0; i < EVENT_QUEUE_SIZE; i++)
 		{
-			last_recovery_time = current_time;
-			interfacesRecoverIfNeeded();
+			queue->slots[i].sequence = i;
 		}
-	}
 
-	console_printf("%s; exit\n");
-	return NULL;
+		queue->head = queue->tail = 0;
+	}
 }
 
 
-static DWPAL_Ret listenerThreadCreate(pthread_t *thread_id, ThreadEntryFunc threadEntryFunc)
+/* Queue an event for a callback worker; returns false if the queue is full. No lock and no syscall (but for waking up a waiting
+ * worker) are involved; the message buffer is handed over, and not copied */
+static bool eventQueuePut(CallbackWorker *worker, EventPriority priority, EventData *eventData)
 {
-	int            ret;
-	DWPAL_Ret      dwpalRet = DWPAL_SUCCESS;
-	pthread_attr_t attr;
-	size_t         stack_size = 4096;
-	//void           *res;
-
-	console_printf("%s Entry\n", __FUNCTION__);
+	EventQueue     *queue = &worker->queues[priority];
+	EventQueueSlot *slot;
+	unsigned int   pos = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+	int            diff;
 
-	ret = pthread_attr_init(&attr);
-	if (ret != 0)
+	while (true)
 	{
-		console_printf("%s; pthread_attr_init ERROR (ret= %d) ==> Abort!\n", __FUNCTION__, ret);
-		return DWPAL_FAILURE;
-	}
+		slot = &queue->slots[pos & (EVENT_QUEUE_SIZE - 1)];
+		diff = (int)(__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) - pos);
 
-	if (pipe(listenerThreadPipeFds) == -1)
-	{
-		console_printf("%s; pipe ERROR (errno= %d) ==> Abort!\n", __FUNCTION__, errno);
-		pthread_attr_destroy(&attr);
-		return DWPAL_FAILURE;
+		if (diff == 0)
+		{  /* the slot is free; claim it, unless another producer got there first */
+			if (__atomic_compare_exchange_n(&queue->head, &pos, pos + 1, true /*weak*/, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			{
+				break;
+			}
+		}
+		else if (diff < 0)
+		{  /* the worker did not release the slot yet; the queue is full */
+			return false;
+		}
+		else
+		{
+			pos = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+		}
 	}
 
-	ret = pthread_attr_setstacksize(&attr, stack_size);
-	if (ret == -1)
-	{
-		console_printf("%s; pthread_attr_setstacksize ERROR (ret= %d) ==> Abort!\n", __FUNCTION__, ret);
-		dwpalRet = DWPAL_FAILURE;
-	}
+	slot->eventData = *eventData;
+	__atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_RELEASE);
 
-	if (dwpalRet == DWPAL_SUCCESS)
-	{
-		listenerThreadShouldStop = 0; /* must be 0 before creating the listener Thread */
+	sem_post(&worker->sem);
 
-		console_printf("%s; call pthread_create\n", __FUNCTION__);
-		ret = pthread_create(thread_id, &attr, threadEntryFunc, NULL /*can be used to send params*/);
-		if (ret != 0)
-		{
-			console_printf("%s; pthread_create ERROR (ret= %d) ==> Abort!\n", __FUNCTION__, ret);
-			dwpalRet = DWPAL_FAILURE;
-		}
-		console_printf("%s; return from call pthread_create, ret= %d\n", __FUNCTION__, ret);
+	return true;
+}
 
-		if (dwpalRet == DWPAL_SUCCESS)
-		{
-#if 0
-			/* Causing the thread to be joined with the main process;
-			   meaning, the process will suspend due to the thread suspend.
-			   Otherwise, when process ends, the thread ends as well (although it is suspended and waiting ) */
-			ret = pthread_join(*thread_id, &res);
-			if (ret != 0)
-			{
-				console_printf("%s; pthread_join ERROR (ret= %d) ==> Abort!\n", __FUNCTION__, ret);
-				dwpalRet = DWPAL_FAILURE;
-			}
 
-			free(res);  /* Free memory allocated by thread */
-#endif
-		}
-	}
+/* Dequeue the next event, the high priority ones first; called by the worker thread only. Returns false if the queues are empty */
+static bool eventQueueGet(CallbackWorker *worker, EventData *eventData /*OUT*/)
+{
+	EventQueue     *queue;
+	EventQueueSlot *slot;
 
-	if (dwpalRet != DWPAL_SUCCESS)
+	for (queue = worker->queues; queue < &worker->queues[NUM_OF_EVENT_PRIORITIES]; queue++)
 	{
-		if (close(listenerThreadPipeFds[0]) != 0)
-		{
-			console_printf("%s; close() to listenerThreadPipeFds[0] FAILED (errno= %d)\n", __FUNCTION__, errno);
-		}
-		if (close(listenerThreadPipeFds[1]) != 0)
+		slot = &queue->slots[queue->tail & (EVENT_QUEUE_SIZE - 1)];
+
+		if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) == queue->tail + 1)
 		{
-			console_printf("%s; close() to listenerThreadPipeFds[1] FAILED (errno= %d)\n", __FUNCTION__, errno);
+			*eventData = slot->eventData;
+			__atomic_store_n(&slot->sequence, queue->tail + EVENT_QUEUE_SIZE, __ATOMIC_RELEASE);
+			queue->tail++;
+
+			return true;
 		}
 	}
 
-	/* Destroy the thread attributes object, since it is no longer needed */
-	ret = pthread_attr_destroy(&attr);
-	if (ret != 0)
-	{
-		console_printf("%s; pthread_attr_destroy ERROR (ret= %d) ==> Abort!\n", __FUNCTION__, ret);
-		dwpalRet = DWPAL_FAILURE;
-	}
+	return false;
+}
 
-	/* sleep for 100 ms - it is needed in case of a loop of thread create/cancel */
-	usleep(100000 /*micro-sec*/);
 
-	return dwpalRet;
+/* All the events of a VAP (or of a driver interface) are queued to the same worker, so that they are delivered in order */
+static CallbackWorker *callbackWorkerGet(const char *VAPName)
+{
+	return &callbackWorkers[stringHashAdd(2166136261u, VAPName) % (unsigned int)numOfCallbackWorkers];
 }
 
 
-static DWPAL_Ret threadSet(pthread_t *thread_id, DwpalThreadOperation threadOperation, ThreadEntryFunc threadEntryFunc)
+static EventPriority hostapEventPriorityGet(const char *opCode)
 {
-	int ret;
+	int i;
 
-	switch (threadOperation)
+	for (i=0; i < numOfHighPriorityOpCodes; i++)
 	{
-		case THREAD_CREATE:
-			if (*thread_id == 0)
-			{
-				if (threadEntryFunc == NULL)
-				{
-					return DWPAL_FAILURE;
-				}
+		if (!strncmp(highPriorityOpCodes[i], opCode, DWPAL_OPCODE_STRING_LENGTH))
+		{
+			return EVENT_PRIORITY_HIGH;
+		}
+	}
 
-				return listenerThreadCreate(thread_id, threadEntryFunc);
-			}
-			break;
+	return EVENT_PRIORITY_NORMAL;
+}
 
-		case THREAD_CANCEL:
-			if (*thread_id != 0)
-			{
-				/* tell the listener Thread to stop, both with flag, and message */
-				listenerThreadShouldStop = 1;
-				if (write(listenerThreadPipeFds[1], "CANCEL", sizeof("CANCEL")) < 0)
-				{
-					console_printf("%s; write to listenerThreadPipeFds[1] FAILED (errno= %d)\n", __FUNCTION__, errno);
-				}
 
-				console_printf("%s; before pthread_join\n", __FUNCTION__);
-				ret = pthread_join(*thread_id, NULL);
-				console_printf("%s; after pthread_join\n", __FUNCTION__);
+static EventPriority nlEventPriorityGet(int subevent)
+{
+	return ( (subevent >= 0) && (subevent < 64) && (highPriorityNlEvents & (1ULL << subevent)) ) ? EVENT_PRIORITY_HIGH : EVENT_PRIORITY_NORMAL;
+}
 
-				if (close(listenerThreadPipeFds[0]) != 0)
-				{
-					console_printf("%s; close() to listenerThreadPipeFds[0] FAILED (errno= %d)\n", __FUNCTION__, errno);
-				}
-				if (close(listenerThreadPipeFds[1]) != 0)
-				{
-					console_printf("%s; close() to listenerThreadPipeFds[1] FAILED (errno= %d)\n", __FUNCTION__, errno);
-				}
 
-				if (ret != 0 && ret != ESRCH)
-				{
-					console_printf("%s;pthread_join ERROR (ret= %d) ==> Abort!\n", __FUNCTION__, ret);
-					return DWPAL_FAILURE;
-				}
+static void hostapEventStatsAdd(unsigned int *counter)
+{
+	pthread_mutex_lock(&stats_mutex);
+	(*counter)++;
+	pthread_mutex_unlock(&stats_mutex);
+}
 
-				*thread_id = 0;
-			}
-			break;
 
-		default:
-			console_printf("%s; threadOperation (%d) not supported ==> Abort!\n", __FUNCTION__, threadOperation);
-			return DWPAL_FAILURE;
-			break;
+static void hostapEventQueueDropCount(EventQueueBound *bound, int opCodeStatsIdx)
+{
+	__atomic_add_fetch(&bound->stats.numOfDropped, 1, __ATOMIC_RELAXED);
+	if (opCodeStatsIdx >= 0)
+	{
+		__atomic_add_fetch(&bound->opCodeStats[opCodeStatsIdx].stats.numOfDropped, 1, __ATOMIC_RELAXED);
 	}
-
-	return DWPAL_SUCCESS;
 }
 
 
-#if defined EVENT_CALLBACK_THREAD
-static int fdDaemonSet(char *socketName, int *fd /* output param */)
+static void hostapEventQueueHighWaterMarkSet(DwpalExtEventQueueStats *stats, unsigned int numOfQueued, unsigned int maxQueued)
 {
-	struct sockaddr_un un;
-	size_t len;
+	/* The skipped events that DROP_OLDEST counts for their op-code till then are not reported beyond the bound */
+	if ( (maxQueued > 0) && (numOfQueued > maxQueued) )
+	{
+		numOfQueued = maxQueued;
+	}
 
-	if ((*fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+	if (numOfQueued > __atomic_load_n(&stats->highWaterMark, __ATOMIC_RELAXED))
 	{
-		console_printf("%s; create socket fail; socketName= '%s'; errno= %d ('%s')\n", __FUNCTION__, socketName, errno, strerror(errno));
-		return DWPAL_FAILURE;
-    }
+		__atomic_store_n(&stats->highWaterMark, numOfQueued, __ATOMIC_RELAXED);
+	}
+}
 
-	console_printf("%s; fd_daemon (socketName='%s') = %d\n", __FUNCTION__, socketName, *fd);
 
-	unlink(socketName);   /* in case it already exists */
+/* Must be called with 'stats_mutex' locked */
+static void hostapEventQueueCountAdd(unsigned int *counter, int delta)
+{
+	__atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + (unsigned int)delta, __ATOMIC_RELAXED);
+}
 
-    /* fill in socket address structure */
-	memset(&un, 0, sizeof(un));
-	un.sun_family = AF_UNIX;
-	strcpy_s(un.sun_path, sizeof(un.sun_path), socketName);
-	len = offsetof(struct sockaddr_un, sun_path) + strnlen_s(socketName, SOCKET_NAME_LENGTH);
 
-    /* bind the name to the descriptor */
-	if (bind(*fd, (struct sockaddr *)&un, len) < 0)  // check if can use connect() instead...
-	{
-		console_printf("%s; bind() fail; errno= %d ('%s')\n", __FUNCTION__, errno, strerror(errno));
+/* Queue an event to the interface's callback worker, counted against the interface's bound; returns false in case that the event is
+ * dropped: by the bound (DROP_NEWEST; an op-code with nothing queued to coalesce; or as many events as the bound are waiting to be
+ * skipped, still holding their worker queue slots), or by a full worker queue. The victims of DROP_OLDEST and COALESCE are marked
+ * only once the event is queued, so that the interface's queued events never exceed the bound.
+ * Called by the producer, with 'services_lock' locked for read */
+static bool hostapEventQueueBoundedPut(int idx, CallbackWorker *worker, EventData *eventData)
+{
+	EventQueueBound       *bound = &dwpalService[idx]->queueBound;
+	EventQueueOpCodeStats *opCodeStats = NULL;
+	bool                  isFull;
+	int                   i;
 
-		if (close(*fd) == (-1))
+	pthread_mutex_lock(&stats_mutex);
+
+	for (i=0; i < bound->numOfOpCodeStats; i++)
+	{
+		if (!strncmp(bound->opCodeStats[i].opCode, eventData->opCode, sizeof(bound->opCodeStats[i].opCode)))
 		{
-			console_printf("%s; close() fail; errno= %d ('%s')\n", __FUNCTION__, errno, strerror(errno));
+			break;
 		}
+	}
 
-		return DWPAL_FAILURE;
-    }
+	if ( (i == bound->numOfOpCodeStats) && (i < EVENT_QUEUE_OPCODE_STATS_MAX) )
+	{
+		memset(&bound->opCodeStats[i], 0, sizeof(bound->opCodeStats[i]));
+		strncpy_s(bound->opCodeStats[i].opCode, sizeof(bound->opCodeStats[i].opCode), eventData->opCode, sizeof(bound->opCodeStats[i].opCode) - 1);
+		__atomic_store_n(&bound->numOfOpCodeStats, i + 1, __ATOMIC_RELEASE);
+	}
 
-	if (chmod(socketName, 0600) < 0)
+	eventData->opCodeStatsIdx = (i < EVENT_QUEUE_OPCODE_STATS_MAX) ? i : (-1);
+	if (eventData->opCodeStatsIdx >= 0)
 	{
-		console_printf("%s; FAIL to chmod '%s' to 0666\n", __FUNCTION__, socketName);
+		opCodeStats = &bound->opCodeStats[i];
+	}
 
-		if (close(*fd) == (-1))
-		{
-			console_printf("%s; close() fail; errno= %d ('%s')\n", __FUNCTION__, errno, strerror(errno));
-		}
+	isFull = ( (bound->maxQueued > 0) && (bound->stats.numOfQueued >= bound->maxQueued) );
 
-		return DWPAL_FAILURE;
-    }
+	if ( (isFull) &&
+	     ( (bound->policy == DWPAL_EXT_EVENT_QUEUE_DROP_NEWEST) ||
+	       ((bound->policy == DWPAL_EXT_EVENT_QUEUE_COALESCE) && ((opCodeStats == NULL) || (opCodeStats->stats.numOfQueued == 0))) ||
+	       (bound->numOfUndelivered - bound->stats.numOfQueued >= bound->maxQueued) ) )
+	{
+		hostapEventQueueDropCount(bound, eventData->opCodeStatsIdx);
+		pthread_mutex_unlock(&stats_mutex);
+		return false;
+	}
 
-	if (listen(*fd, 10 /*Q Length*/) < 0)
-	{ /* tell kernel we're a server */
-		console_printf("%s; listen fail\n", __FUNCTION__);
+	eventData->isBounded = true;
+	eventData->sequence = bound->sequence + 1;
 
-		if (close(*fd) == (-1))
-		{
-			console_printf("%s; close() fail; errno= %d ('%s')\n", __FUNCTION__, errno, strerror(errno));
+	/* The worker may dequeue the event right away; it releases it only once this is done, as it locks 'stats_mutex' for it */
+	if (!eventQueuePut(worker, EVENT_PRIORITY_NORMAL, eventData))
+	{
+		hostapEventQueueDropCount(bound, eventData->opCodeStatsIdx);
+		pthread_mutex_unlock(&stats_mutex);
+
+		console_printf("%s; event queue is full ==> event dropped\n", __FUNCTION__);
+		hostapEventStatsAdd(&dwpalService[idx]->eventStats.numOfDroppedEvents);
+		return false;
+	}
+
+	bound->sequence++;
+	bound->numOfUndelivered++;
+
+	if ( (isFull) && (bound->policy == DWPAL_EXT_EVENT_QUEUE_DROP_OLDEST) )
+	{  /* the oldest event is replaced by this one */
+		bound->numOfDropsPending++;
+	}
+	else
+	{
+		if (isFull)
+		{  /* COALESCE: the op-code's queued events are replaced by this one */
+			hostapEventQueueCountAdd(&bound->stats.numOfQueued, -(int)opCodeStats->stats.numOfQueued);
+			hostapEventQueueCountAdd(&opCodeStats->stats.numOfQueued, -(int)opCodeStats->stats.numOfQueued);
+			opCodeStats->supersedingSequence = eventData->sequence;
 		}
 
-		return DWPAL_FAILURE;
+		hostapEventQueueCountAdd(&bound->stats.numOfQueued, 1);
+		hostapEventQueueHighWaterMarkSet(&bound->stats, bound->stats.numOfQueued, bound->maxQueued);
 	}
 
-	return DWPAL_SUCCESS;
+	if (opCodeStats != NULL)
+	{
+		hostapEventQueueCountAdd(&opCodeStats->stats.numOfQueued, 1);
+		hostapEventQueueHighWaterMarkSet(&opCodeStats->stats, opCodeStats->stats.numOfQueued, bound->maxQueued);
+	}
+
+	pthread_mutex_unlock(&stats_mutex);
+
+	return true;
 }
 
 
-static DWPAL_Ret dwpal_socket_create(int *fd, char *socketPrefixName)
+/* Un-count a dequeued event; returns false in case that it is to be skipped, and not delivered: it is one of the oldest events
+ * (DROP_OLDEST), or a newer event of its op-code superseded it (COALESCE). Called by the consumer */
+static bool hostapEventQueueRelease(EventQueueBound *bound, EventData *eventData)
 {
-	pid_t pid = getpid();
-	char  socketName[SOCKET_NAME_LENGTH] = "\0";
+	EventQueueOpCodeStats *opCodeStats = (eventData->opCodeStatsIdx >= 0) ? &bound->opCodeStats[eventData->opCodeStatsIdx] : NULL;
+	bool                  isDropped = true;
 
-	snprintf_s(socketName, sizeof(socketName), "%s_%d", socketPrefixName, pid);
+	pthread_mutex_lock(&stats_mutex);
 
-	if (*fd > 0)
-	{
-		console_printf("%s; *fd (%d) ==> cont...\n", __FUNCTION__, *fd);
-		return DWPAL_SUCCESS;
+	bound->numOfUndelivered--;
+
+	if (bound->numOfDropsPending > 0)
+	{  /* already replaced in the interface's count, but not in its op-code's */
+		bound->numOfDropsPending--;
+		if (opCodeStats != NULL)
+		{
+			hostapEventQueueCountAdd(&opCodeStats->stats.numOfQueued, -1);
+		}
+	}
+	else if ( (opCodeStats == NULL) || ((int)(opCodeStats->supersedingSequence - eventData->sequence) <= 0) )
+	{  /* otherwise, a newer event of its op-code superseded it, and it was already replaced in both counts */
+		hostapEventQueueCountAdd(&bound->stats.numOfQueued, -1);
+		if (opCodeStats != NULL)
+		{
+			hostapEventQueueCountAdd(&opCodeStats->stats.numOfQueued, -1);
+		}
+		isDropped = false;
 	}
 
-	if (fdDaemonSet(socketName, fd /*output*/) == DWPAL_FAILURE)
+	if (isDropped)
 	{
-		console_printf("%s; ERROR; *fd= %d\n", __FUNCTION__, *fd);
-		return DWPAL_FAILURE;
+		hostapEventQueueDropCount(bound, eventData->opCodeStatsIdx);
 	}
 
-	return DWPAL_SUCCESS;
+	pthread_mutex_unlock(&stats_mutex);
+
+	return !isDropped;
 }
-#endif
 
 
-static DWPAL_Ret nlCmdGetCallback(char *ifname, int event, int subevent, size_t len, unsigned char *data)
+/* Parse the op-code out of a hostapd event (i.e. "<3>AP-STA-CONNECTED wlan0 ..."), the same way dwpal_hostap_event_get does */
+static void hostapEventOpCodeGet(char *msg, char *opCode /*OUT*/, size_t opCodeSize)
 {
-	console_printf("%s Entry; ifname= '%s', event= %d, subevent= %d (len= %d)\n", __FUNCTION__, ifname, event, subevent, len);
+	char   *p2str = strchr(msg, '>');
+	size_t len;
 
-	(void)ifname;
+	opCode[0] = '\0';
+
+	if (p2str == NULL)
+	{
+		return;
+	}
+
+	p2str++;
+	len = strcspn(p2str, " ");
+	if (len >= opCodeSize)
+	{
+		len = opCodeSize - 1;
+	}
+
+	memcpy(opCode, p2str, len);
+	opCode[len] = '\0';
+}
+
+
+/* Whether the event should be delivered to the interface's callback, according to its subscription */
+static bool isEventSubscribed(int idx, const char *opCode)
+{
+	size_t i;
+
+	if (dwpalService[idx]->subscribedOpCodes == NULL)
+	{
+		return true;
+	}
+
+	for (i=0; i < dwpalService[idx]->numOfSubscribedOpCodes; i++)
+	{
+		if (!strncmp(opCode, dwpalService[idx]->subscribedOpCodes[i], DWPAL_OPCODE_STRING_LENGTH))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+/* Whether the event should be received; the station events are tracked even if not subscribed to */
+static bool isEventWanted(int idx, const char *opCode)
+{
+	return ( (isEventSubscribed(idx, opCode)) ||
+	         ( (dwpalService[idx]->state != NULL) &&
+	           ( (!strncmp(opCode, "AP-STA-CONNECTED", sizeof("AP-STA-CONNECTED"))) ||
+	             (!strncmp(opCode, "AP-STA-DISCONNECTED", sizeof("AP-STA-DISCONNECTED"))) ) ) );
+}
+
+
+/* In case that the pending event of the interface is not wanted, drop it in the socket, and return true */
+static bool hostapEventUnsubscribedDiscard(int idx)
+{
+	char opCode[DWPAL_OPCODE_STRING_LENGTH];
+
+	if ( (dwpalService[idx]->subscribedOpCodes == NULL) ||
+	     (dwpal_hostap_event_opcode_peek(context[idx], opCode /*OUT*/, sizeof(opCode)) != DWPAL_SUCCESS) ||
+	     (opCode[0] == '\0') /* not an event; i.e. a PONG */ ||
+	     (isEventWanted(idx, opCode)) )
+	{
+		return false;
+	}
+
+	return (dwpal_hostap_event_discard(context[idx]) == DWPAL_SUCCESS);
+}
+
+
+/* Push the interface's events level down to hostapd; called with 'context_mutex' locked */
+static void hostapEventLevelApply(int idx)
+{
+	int level = (dwpalService[idx]->eventLevel == 0) ? HOSTAP_DEFAULT_EVENT_LEVEL : dwpalService[idx]->eventLevel;
+
+	cmdServiceIdx = idx;  /* for two-way interfaces' events, received while waiting for the reply */
+	if (dwpal_hostap_event_level_set(context[idx], level) != DWPAL_SUCCESS)
+	{
+		console_printf("%s; dwpal_hostap_event_level_set (VAPName= '%s', level= %d) returned ERROR ==> cont...\n", __FUNCTION__, dwpalService[idx]->VAPName, level);
+	}
+	cmdServiceIdx = -1;
+}
+
+
+/* Two-way interfaces' callback for events received while a command is waiting for its reply.
+ * It is called with 'context_mutex' locked, so the event is only queued; the listener thread delivers it */
+static void hostapTwoWayEventCallback(char *msg, size_t len)
+{
+	DeferredEvent *deferredEvent;
+	char          opCode[DWPAL_OPCODE_STRING_LENGTH];
+
+	if ( (cmdServiceIdx < 0) || (dwpalService[cmdServiceIdx] == NULL) )
+	{
+		console_printf("%s; event received out of a command send ==> dropped\n", __FUNCTION__);
+		return;
+	}
+
+	if (dwpalService[cmdServiceIdx]->subscribedOpCodes != NULL)
+	{
+		hostapEventOpCodeGet(msg, opCode, sizeof(opCode));
+		if (!isEventWanted(cmdServiceIdx, opCode))
+		{
+			return;
+		}
+	}
+
+	deferredEvent = (DeferredEvent *)malloc(sizeof(DeferredEvent) + len + 1);
+	if (deferredEvent == NULL)
+	{
+		console_printf("%s; malloc failed ==> event dropped\n", __FUNCTION__);
+		hostapEventStatsAdd(&dwpalService[cmdServiceIdx]->eventStats.numOfDroppedEvents);
+		return;
+	}
+
+	deferredEvent->next = NULL;
+	strcpy_s(deferredEvent->VAPName, sizeof(deferredEvent->VAPName), dwpalService[cmdServiceIdx]->VAPName);
+	memcpy(deferredEvent->msg, msg, len);
+	deferredEvent->msg[len] = '\0';
+	deferredEvent->msgLen = len;
+
+	pthread_mutex_lock(&deferred_mutex);
+	if (deferredEventTail == NULL)
+	{
+		deferredEventHead = deferredEvent;
+	}
+	else
+	{
+		deferredEventTail->next = deferredEvent;
+	}
+	deferredEventTail = deferredEvent;
+	pthread_mutex_unlock(&deferred_mutex);
+
+	listenerThreadWakeUp();
+}
+
+
+/* Deliver a hostapd event to the callback of the interface */
+static void hostapEventDispatch(int idx, char *opCode, char *msg, size_t msgStringLen)
+{
+	EventData     eventData;
+	EventPriority priority;
+	bool          isQueued;
+
+	if (numOfCallbackWorkers == 0)
+	{
+		if (dwpalService[idx]->hostapEventCallback != NULL)
+		{
+			dwpalService[idx]->hostapEventCallback(dwpalService[idx]->VAPName, opCode, msg, msgStringLen);
+		}
+
+		return;
+	}
+
+	memset(&eventData, 0, sizeof(eventData));
+	eventData.type = EVENT_TYPE_HOSTAP;
+	eventData.serviceIdx = idx;
+	strcpy_s(eventData.VAPName, sizeof(eventData.VAPName), dwpalService[idx]->VAPName);
+	strcpy_s(eventData.opCode, sizeof(eventData.opCode), opCode);
+
+	/* A latency-critical station event takes the fast lane only when none of its interface's events is queued, for it not to overtake
+	 * an earlier event of the same station (i.e. "AP-STA-DISCONNECTED" delivered ahead of its "AP-STA-CONNECTED") */
+	priority = hostapEventPriorityGet(opCode);
+	if ( (priority == EVENT_PRIORITY_HIGH) && (!strncmp(opCode, "AP-STA-", sizeof("AP-STA-") - 1)) &&
+	     (__atomic_load_n(&dwpalService[idx]->queueBound.stats.numOfQueued, __ATOMIC_ACQUIRE) > 0) )
+	{
+		priority = EVENT_PRIORITY_NORMAL;
+	}
+
+	/* The message is copied (as long as it is) into a pooled buffer, that the worker releases */
+	if (msg != NULL)
+	{
+		if ((eventData.msg = eventBufferGet(msgStringLen + 1)) == NULL)
+		{
+			console_printf("%s; eventBufferGet failed ==> event dropped\n", __FUNCTION__);
+			hostapEventStatsAdd(&dwpalService[idx]->eventStats.numOfDroppedEvents);
+			return;
+		}
+
+		memcpy(eventData.msg, msg, msgStringLen);
+		eventData.msg[msgStringLen] = '\0';
+		eventData.msgStringLen = msgStringLen;
+	}
+
+	/* Send the event via the callback; the latency-critical events are not bounded */
+	if (priority == EVENT_PRIORITY_NORMAL)
+	{
+		isQueued = hostapEventQueueBoundedPut(idx, callbackWorkerGet(eventData.VAPName), &eventData);
+	}
+	else if (!(isQueued = eventQueuePut(callbackWorkerGet(eventData.VAPName), priority, &eventData)))
+	{
+		console_printf("%s; event queue is full ==> event dropped\n", __FUNCTION__);
+		hostapEventStatsAdd(&dwpalService[idx]->eventStats.numOfDroppedEvents);
+	}
+
+	if (!isQueued)
+	{
+		eventDataRelease(&eventData);
+	}
+}
+
+
+/* The driver events' callbacks, in case of callback workers: the events are queued to the worker of their interface */
+static DWPAL_Ret nlEventQueue(char *ifname, int event, int subevent, size_t len, unsigned char *data)
+{
+	EventData eventData;
+
+	memset(&eventData, 0, sizeof(eventData));
+	eventData.type = EVENT_TYPE_NL_VENDOR;
+	eventData.event = event;
+	eventData.subevent = subevent;
+	strcpy_s(eventData.VAPName, sizeof(eventData.VAPName), (ifname != NULL) ? ifname : "");
+
+	if ( (interfaceIndexGet("Driver", "ALL", &eventData.serviceIdx) != DWPAL_SUCCESS) ||
+	     ((len > 0) && ((eventData.msg = eventBufferGet(len)) == NULL)) )
+	{
+		console_printf("%s; ifname= '%s' event= %d, subevent= %d ==> event dropped\n", __FUNCTION__, eventData.VAPName, event, subevent);
+		return DWPAL_FAILURE;
+	}
+
+	if (len > 0)
+	{
+		memcpy(eventData.msg, data, len);
+		eventData.msgStringLen = len;
+	}
+
+	if (!eventQueuePut(callbackWorkerGet(eventData.VAPName), nlEventPriorityGet(subevent), &eventData))
+	{
+		console_printf("%s; event queue is full (ifname= '%s') ==> event dropped\n", __FUNCTION__, eventData.VAPName);
+		eventDataRelease(&eventData);
+		return DWPAL_FAILURE;
+	}
+
+	return DWPAL_SUCCESS;
+}
+
+
+static DWPAL_Ret nlNonVendorEventQueue(struct nl_msg *msg)
+{
+	EventData eventData;
+
+	memset(&eventData, 0, sizeof(eventData));
+	eventData.type = EVENT_TYPE_NL_NON_VENDOR;
+
+	if (interfaceIndexGet("Driver", "ALL", &eventData.serviceIdx) != DWPAL_SUCCESS)
+	{
+		return DWPAL_FAILURE;
+	}
+
+	/* The message is freed by libnl once this callback returns; keep it referenced till it is delivered */
+	nlmsg_get(msg);
+	eventData.nlMsg = msg;
+
+	if (!eventQueuePut(callbackWorkerGet("Driver"), EVENT_PRIORITY_NORMAL, &eventData))
+	{
+		console_printf("%s; event queue is full ==> event dropped\n", __FUNCTION__);
+		eventDataRelease(&eventData);
+		return DWPAL_FAILURE;
+	}
+
+	return DWPAL_SUCCESS;
+}
+
+
+static void timespecAddMs(struct timespec *ts, unsigned int ms)
+{
+	ts->tv_sec += ms / 1000;
+	ts->tv_nsec += (long)(ms % 1000) * 1000000L;
+	if (ts->tv_nsec >= 1000000000L)
+	{
+		ts->tv_sec++;
+		ts->tv_nsec -= 1000000000L;
+	}
+}
+
+
+static bool isTimespecExpired(struct timespec *ts)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return ( (now.tv_sec > ts->tv_sec) || ((now.tv_sec == ts->tv_sec) && (now.tv_nsec >= ts->tv_nsec)) );
+}
+
+
+/* The time left till 'ts', in milliseconds (0 if passed) */
+static int timespecMsLeftGet(struct timespec *ts)
+{
+	struct timespec now;
+	long long       msLeft;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	msLeft = (long long)(ts->tv_sec - now.tv_sec) * 1000 + (ts->tv_nsec - now.tv_nsec + 999999L) / 1000000L;
+
+	return (msLeft > 0) ? (int)msLeft : 0;
+}
+
+
+static bool isTimespecEarlier(struct timespec *ts1, struct timespec *ts2)
+{
+	return ( (ts1->tv_sec < ts2->tv_sec) || ((ts1->tv_sec == ts2->tv_sec) && (ts1->tv_nsec < ts2->tv_nsec)) );
+}
+
+
+/* The policy of an op-code, or (-1) if it is neither coalesced nor rate limited */
+static int eventCoalescePolicyGet(const char *opCode)
+{
+	int i;
+
+	for (i=0; i < numOfEventCoalescePolicies; i++)
+	{
+		if (!strncmp(eventCoalescePolicy[i].opCode, opCode, sizeof(eventCoalescePolicy[i].opCode)))
+		{
+			return ( (eventCoalescePolicy[i].windowMs > 0) || (eventCoalescePolicy[i].maxPerSec > 0) ) ? i : (-1);
+		}
+	}
+
+	return (-1);
+}
+
+
+/* The station MAC of a hostapd event; it is the token that follows the VAP name (i.e. "<3>UNCONNECTED-STA-RSSI wlan0 24:77:03:80:5d:90 ..."),
+ * or empty in case that it is not a MAC address */
+static void hostapEventMACAddressGet(const char *msg, char *MACAddress /*OUT*/)
+{
+	const char *p2str;
+
+	MACAddress[0] = '\0';
+
+	/* Skip the op-code and the VAP name */
+	if ( ((p2str = strchr(msg, ' ')) == NULL) || ((p2str = strchr(p2str + 1, ' ')) == NULL) )
+	{
+		return;
+	}
+	p2str++;
+
+	if ( (strcspn(p2str, " ") == MAC_ADDR_STRING_LENGTH - 1) && (p2str[2] == ':') && (p2str[14] == ':') )
+	{
+		memcpy(MACAddress, p2str, MAC_ADDR_STRING_LENGTH - 1);
+		MACAddress[MAC_ADDR_STRING_LENGTH - 1] = '\0';
+	}
+}
+
+
+static void hostapEventSuppressedAdd(int idx, int policyIdx)
+{
+	pthread_mutex_lock(&stats_mutex);
+	dwpalService[idx]->coalesce.numOfSuppressed[policyIdx]++;
+	dwpalService[idx]->eventStats.numOfSuppressedEvents++;
+	pthread_mutex_unlock(&stats_mutex);
+}
+
+
+/* Deliver the event, unless the op-code's rate limit for the current second was reached */
+static void hostapEventRateLimitedDispatch(int idx, int policyIdx, char *opCode, char *msg, size_t msgStringLen)
+{
+	EventCoalesceState *coalesce = &dwpalService[idx]->coalesce;
+	time_t             current_time;
+
+	if (eventCoalescePolicy[policyIdx].maxPerSec > 0)
+	{
+		current_time = time(NULL);
+		if (coalesce->rateSecond[policyIdx] != current_time)
+		{
+			coalesce->rateSecond[policyIdx] = current_time;
+			coalesce->rateCount[policyIdx] = 0;
+		}
+
+		if (coalesce->rateCount[policyIdx] >= eventCoalescePolicy[policyIdx].maxPerSec)
+		{
+			hostapEventSuppressedAdd(idx, policyIdx);
+			return;
+		}
+
+		coalesce->rateCount[policyIdx]++;
+	}
+
+	hostapEventDispatch(idx, opCode, msg, msgStringLen);
+}
+
+
+/* Deliver the event according to the policy of its op-code: as is, rate limited, or held back for its coalescing window;
+ * a held event of the same (op-code, MAC) is replaced by the new one, and counted as suppressed */
+static void hostapEventCoalesce(int idx, char *opCode, char *msg, size_t msgStringLen)
+{
+	int            policyIdx = eventCoalescePolicyGet(opCode);
+	char           MACAddress[MAC_ADDR_STRING_LENGTH];
+	CoalescedEvent *coalescedEvent;
+
+	if (policyIdx < 0)
+	{
+		hostapEventDispatch(idx, opCode, msg, msgStringLen);
+		return;
+	}
+
+	if ( (eventCoalescePolicy[policyIdx].windowMs == 0) || (msg == NULL) )
+	{
+		hostapEventRateLimitedDispatch(idx, policyIdx, opCode, msg, msgStringLen);
+		return;
+	}
+
+	hostapEventMACAddressGet(msg, MACAddress);
+
+	for (coalescedEvent = dwpalService[idx]->coalesce.coalescedHead; coalescedEvent != NULL; coalescedEvent = coalescedEvent->next)
+	{
+		if ( (coalescedEvent->policyIdx == policyIdx) && (!strncmp(coalescedEvent->MACAddress, MACAddress, sizeof(MACAddress))) )
+		{
+			break;
+		}
+	}
+
+	if (coalescedEvent == NULL)
+	{
+		if ((coalescedEvent = (CoalescedEvent *)calloc(1, sizeof(CoalescedEvent))) == NULL)
+		{
+			console_printf("%s; malloc failed ==> event delivered as is\n", __FUNCTION__);
+			hostapEventRateLimitedDispatch(idx, policyIdx, opCode, msg, msgStringLen);
+			return;
+		}
+
+		coalescedEvent->policyIdx = policyIdx;
+		strcpy_s(coalescedEvent->MACAddress, sizeof(coalescedEvent->MACAddress), MACAddress);
+		clock_gettime(CLOCK_MONOTONIC, &coalescedEvent->expiry);
+		timespecAddMs(&coalescedEvent->expiry, eventCoalescePolicy[policyIdx].windowMs);
+		coalescedEvent->next = dwpalService[idx]->coalesce.coalescedHead;
+		dwpalService[idx]->coalesce.coalescedHead = coalescedEvent;
+
+		if ( (!isCoalescedEventPending) || (isTimespecEarlier(&coalescedEvent->expiry, &coalescedEventNextExpiry)) )
+		{
+			coalescedEventNextExpiry = coalescedEvent->expiry;
+			isCoalescedEventPending = true;
+		}
+	}
+	else
+	{
+		hostapEventSuppressedAdd(idx, policyIdx);
+	}
+
+	if (msgStringLen + 1 > coalescedEvent->msgBufSize)
+	{
+		char *newMsg = (char *)realloc(coalescedEvent->msg, msgStringLen + 1);
+
+		if (newMsg == NULL)
+		{
+			console_printf("%s; realloc failed ==> event dropped\n", __FUNCTION__);
+			hostapEventStatsAdd(&dwpalService[idx]->eventStats.numOfDroppedEvents);
+			return;
+		}
+
+		coalescedEvent->msg = newMsg;
+		coalescedEvent->msgBufSize = msgStringLen + 1;
+	}
+
+	memcpy(coalescedEvent->msg, msg, msgStringLen);
+	coalescedEvent->msg[msgStringLen] = '\0';
+	coalescedEvent->msgLen = msgStringLen;
+}
+
+
+/* Deliver the held events whose coalescing window passed; called by the listener with 'services_lock' locked for read */
+static void coalescedEventsFlush(void)
+{
+	int            idx;
+	CoalescedEvent *coalescedEvent, **p2coalescedEvent;
+
+	if ( (!isCoalescedEventPending) || (!isTimespecExpired(&coalescedEventNextExpiry)) )
+	{
+		return;
+	}
+
+	isCoalescedEventPending = false;
+
+	for (idx=0; idx < numOfServices; idx++)
+	{
+		if ( (dwpalService[idx] == NULL) || (dwpalService[idx]->coalesce.coalescedHead == NULL) )
+		{
+			continue;
+		}
+
+		p2coalescedEvent = &dwpalService[idx]->coalesce.coalescedHead;
+		while ((coalescedEvent = *p2coalescedEvent) != NULL)
+		{
+			if (!isTimespecExpired(&coalescedEvent->expiry))
+			{
+				if ( (!isCoalescedEventPending) || (isTimespecEarlier(&coalescedEvent->expiry, &coalescedEventNextExpiry)) )
+				{
+					coalescedEventNextExpiry = coalescedEvent->expiry;
+					isCoalescedEventPending = true;
+				}
+
+				p2coalescedEvent = &coalescedEvent->next;
+				continue;
+			}
+
+			/* Unlinked before the callback, that may send commands (and so receive deferred events) */
+			*p2coalescedEvent = coalescedEvent->next;
+
+			if (coalescedEvent->msg != NULL)
+			{
+				hostapEventRateLimitedDispatch(idx, coalescedEvent->policyIdx, eventCoalescePolicy[coalescedEvent->policyIdx].opCode,
+				                               coalescedEvent->msg, coalescedEvent->msgLen);
+			}
+
+			free((void *)coalescedEvent->msg);
+			free((void *)coalescedEvent);
+		}
+	}
+}
+
+
+/* Track the interface state by the event, and deliver it to the callback (in case that it is subscribed to) */
+static void hostapEventHandle(int idx, char *opCode, char *msg, size_t msgStringLen)
+{
+	if (dwpalService[idx]->state != NULL)
+	{
+		hostapStateEventUpdate(dwpalService[idx]->state, opCode, msg);
+	}
+
+	if (isEventSubscribed(idx, opCode))
+	{
+		hostapEventCoalesce(idx, opCode, msg, msgStringLen);
+	}
+}
+
+
+/* Deliver the events that were received by two-way interfaces while sending commands */
+static void deferredEventsDispatch(void)
+{
+	int           idx;
+	char          opCode[DWPAL_OPCODE_STRING_LENGTH];
+	DeferredEvent *deferredEvent;
+
+	pthread_mutex_lock(&deferred_mutex);
+	deferredEvent = deferredEventHead;
+	deferredEventHead = deferredEventTail = NULL;
+	pthread_mutex_unlock(&deferred_mutex);
+
+	while (deferredEvent != NULL)
+	{
+		DeferredEvent *next = deferredEvent->next;
+
+		hostapEventOpCodeGet(deferredEvent->msg, opCode, sizeof(opCode));
+
+		/* The interface may have been detached in the meantime */
+		if ( (opCode[0] != '\0') && (interfaceIndexGet("hostap", deferredEvent->VAPName, &idx) == DWPAL_SUCCESS) )
+		{
+			hostapEventHandle(idx, opCode, deferredEvent->msg, deferredEvent->msgLen);
+		}
+
+		free((void *)deferredEvent);
+		deferredEvent = next;
+	}
+}
+
+
+/* Must be called with 'cache_mutex' locked */
+static unsigned int cmdCacheTtlGet(char *cmdHeader)
+{
+	int    i;
+	size_t cmdNameLen = strcspn(cmdHeader, " ");
+
+	for (i=0; i < numOfCmdCachePolicies; i++)
+	{
+		if ( (strnlen_s(cmdCachePolicy[i].cmdName, sizeof(cmdCachePolicy[i].cmdName)) == cmdNameLen) &&
+		     (!strncmp(cmdCachePolicy[i].cmdName, cmdHeader, cmdNameLen)) )
+		{
+			return cmdCachePolicy[i].ttlMs;
+		}
+	}
+
+	return 0;
+}
+
+
+/* Must be called with 'cache_mutex' locked */
+static CmdCacheEntry *cmdCacheEntryGet(char *VAPName, char *cmd)
+{
+	CmdCacheEntry *entry;
+
+	for (entry = cmdCacheHead; entry != NULL; entry = entry->next)
+	{
+		if ( (!strncmp(entry->VAPName, VAPName, sizeof(entry->VAPName))) &&
+		     (!strncmp(entry->cmd, cmd, sizeof(entry->cmd))) )
+		{
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+
+/* Must be called with 'cache_mutex' locked; entries in use (in-flight, or with waiters) are only expired, not freed */
+static void cmdCacheEntriesRemove(char *VAPName, bool isExpiredOnly)
+{
+	CmdCacheEntry **entryPtr = &cmdCacheHead, *entry;
+
+	if (!isExpiredOnly)
+	{
+		cmdCacheFlushGeneration++;
+	}
+
+	while ((entry = *entryPtr) != NULL)
+	{
+		if ( (VAPName != NULL) && strncmp(entry->VAPName, VAPName, sizeof(entry->VAPName)) )
+		{
+			entryPtr = &entry->next;
+			continue;
+		}
+
+		if ( entry->isInFlight || (entry->numOfWaiters > 0) )
+		{
+			if (!isExpiredOnly)
+			{
+				clock_gettime(CLOCK_MONOTONIC, &entry->expiry);
+			}
+			entryPtr = &entry->next;
+			continue;
+		}
+
+		if ( isExpiredOnly && !isTimespecExpired(&entry->expiry) )
+		{
+			entryPtr = &entry->next;
+			continue;
+		}
+
+		*entryPtr = entry->next;
+		free((void *)entry->reply);
+		free((void *)entry);
+	}
+}
+
+
+/* Must be called with 'cache_mutex' locked */
+static void cmdCacheReplyCopy(CmdCacheEntry *entry, char *reply /*OUT*/, size_t *replyLen /*IN/OUT*/)
+{
+	size_t len = (entry->replyLen < *replyLen) ? entry->replyLen : *replyLen;
+
+	if (len > 0)
+	{
+		memcpy(reply, entry->reply, len);
+	}
+	reply[len] = '\0';
+	*replyLen = len;
+}
+
+
+/* Must be called with 'cache_mutex' locked; 'flushGeneration' is the 'cmdCacheFlushGeneration' read before the request was sent - the
+ * reply of a request that a flush took place during is shared with the current waiters only, as it may predate the flushed change */
+static void cmdCacheReplyStore(CmdCacheEntry *entry, DWPAL_Ret ret, char *reply, size_t replyLen, unsigned int ttlMs, unsigned int flushGeneration)
+{
+	entry->ret = ret;
+	clock_gettime(CLOCK_MONOTONIC, &entry->expiry);
+
+	if (ret == DWPAL_SUCCESS)
+	{
+		if (entry->replyBufSize < replyLen + 1)
+		{
+			char *newReply = (char *)realloc(entry->reply, replyLen + 1);
+
+			if (newReply == NULL)
+			{
+				console_printf("%s; realloc failed ==> reply not cached\n", __FUNCTION__);
+				entry->replyLen = 0;
+				entry->ret = DWPAL_FAILURE;
+				return;
+			}
+
+			entry->reply = newReply;
+			entry->replyBufSize = replyLen + 1;
+		}
+
+		memcpy(entry->reply, reply, replyLen);
+		entry->reply[replyLen] = '\0';
+		entry->replyLen = replyLen;
+
+		/* Failed requests are shared with the current waiters only, and never served from the cache */
+		if (flushGeneration == cmdCacheFlushGeneration)
+		{
+			timespecAddMs(&entry->expiry, ttlMs);
+		}
+	}
+}
+
+
+/* The caller may have resolved 'idx' and unlocked 'services_lock' since; 'VAPName' tells whether it is still the same interface.
+ * In case of 'isReplyAlloc', '*reply' is allocated to the size of the reply, and should be freed by the caller */
+static DWPAL_Ret hostapCmdSend(int idx, char *VAPName, char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char **reply /*IN/OUT*/, size_t *replyLen /*IN/OUT*/, bool isReplyAlloc, unsigned int timeoutMs)
+{
+	DWPAL_Ret ret;
+
+	pthread_mutex_lock(&context_mutex);
+	if ( (dwpalService[idx] == NULL) || (strncmp(dwpalService[idx]->VAPName, VAPName, sizeof(dwpalService[idx]->VAPName))) )
+	{  /* detached in the meantime (and its index possibly re-used by another interface) */
+		*replyLen = 0;
+		pthread_mutex_unlock(&context_mutex);
+		return DWPAL_INTERFACE_IS_DOWN;
+	}
+
+	if (dwpalService[idx]->isConnectionEstablishNeeded == true)
+	{
+		console_printf("%s; interface is being reconnected, but still NOT ready ==> Abort!\n", __FUNCTION__);
+		*replyLen = 0;
+		pthread_mutex_unlock(&context_mutex);
+		return DWPAL_INTERFACE_IS_DOWN;
+	}
+
+	if (context[idx] == NULL)
+	{
+		console_printf("%s; context[%d] is NULL ==> Abort!\n", __FUNCTION__, idx);
+		*replyLen = 0;
+		pthread_mutex_unlock(&context_mutex);
+		return DWPAL_FAILURE;
+	}
+
+	cmdServiceIdx = idx;  /* for two-way interfaces' events, received while waiting for the reply */
+	if (isReplyAlloc)
+	{
+		ret = dwpal_hostap_cmd_send_alloc(context[idx], cmdHeader, fieldsToCmdParse, reply, replyLen, timeoutMs);
+	}
+	else
+	{
+		ret = dwpal_hostap_cmd_send_timeout(context[idx], cmdHeader, fieldsToCmdParse, *reply, replyLen, timeoutMs);
+	}
+	cmdServiceIdx = -1;
+
+	if (ret != DWPAL_SUCCESS)
+	{
+		console_printf("%s; '%s' command send error (ret= %d)\n", __FUNCTION__, cmdHeader, ret);
+		*replyLen = 0;
+		pthread_mutex_unlock(&context_mutex);
+		return (ret == DWPAL_TIMEOUT) ? DWPAL_TIMEOUT : DWPAL_FAILURE;
+	}
+	pthread_mutex_unlock(&context_mutex);
+
+	return DWPAL_SUCCESS;
+}
+
+
+/* Serve the command from the reply cache; identical concurrent requests are collapsed into one hostapd round trip */
+static DWPAL_Ret hostapCmdSendCached(int idx, char *VAPName, char *cmdHeader, unsigned int ttlMs, char *reply /*OUT*/, size_t *replyLen /*IN/OUT*/, unsigned int timeoutMs)
+{
+	CmdCacheEntry *entry;
+	unsigned int  flushGeneration;
+	DWPAL_Ret     ret;
+
+	pthread_mutex_lock(&cache_mutex);
+
+	cmdCacheEntriesRemove(VAPName, true /*isExpiredOnly*/);
+
+	entry = cmdCacheEntryGet(VAPName, cmdHeader);
+	if (entry != NULL)
+	{
+		if (entry->isInFlight)
+		{
+			/* Another thread is already waiting for the very same reply; share it */
+			entry->numOfWaiters++;
+			while (entry->isInFlight)
+			{
+				pthread_cond_wait(&cache_cond, &cache_mutex);
+			}
+			entry->numOfWaiters--;
+
+			ret = entry->ret;
+			if (ret == DWPAL_SUCCESS)
+			{
+				cmdCacheReplyCopy(entry, reply, replyLen);
+			}
+			else
+			{
+				*replyLen = 0;
+			}
+
+			pthread_mutex_unlock(&cache_mutex);
+			return ret;
+		}
+
+		if (!isTimespecExpired(&entry->expiry))
+		{
+			cmdCacheReplyCopy(entry, reply, replyLen);
+			pthread_mutex_unlock(&cache_mutex);
+			return DWPAL_SUCCESS;
+		}
+	}
+	else
+	{
+		entry = (CmdCacheEntry *)calloc(1, sizeof(CmdCacheEntry));
+		if (entry == NULL)
+		{
+			pthread_mutex_unlock(&cache_mutex);
+			console_printf("%s; calloc failed ==> send without caching\n", __FUNCTION__);
+			return hostapCmdSend(idx, VAPName, cmdHeader, NULL, &reply, replyLen, false /*isReplyAlloc*/, timeoutMs);
+		}
+
+		strncpy_s(entry->VAPName, sizeof(entry->VAPName), VAPName, sizeof(entry->VAPName) - 1);
+		strncpy_s(entry->cmd, sizeof(entry->cmd), cmdHeader, sizeof(entry->cmd) - 1);
+		entry->next = cmdCacheHead;
+		cmdCacheHead = entry;
+	}
+
+	entry->isInFlight = true;
+	flushGeneration = cmdCacheFlushGeneration;
+	pthread_mutex_unlock(&cache_mutex);
+
+	ret = hostapCmdSend(idx, VAPName, cmdHeader, NULL, &reply, replyLen, false /*isReplyAlloc*/, timeoutMs);
+
+	pthread_mutex_lock(&cache_mutex);
+	cmdCacheReplyStore(entry, ret, reply, *replyLen, ttlMs, flushGeneration);
+	entry->isInFlight = false;
+	pthread_cond_broadcast(&cache_cond);
+	pthread_mutex_unlock(&cache_mutex);
+
+	return ret;
+}
+
+
+/* Continue taking the interface's state: the station list (via STA-FIRST/STA-NEXT), and the radio info, till 'budgetExpiry' passed;
+ * each command is given what is left of the budget, and a command that timed out is retried on the next round.
+ * The snapshot is taken once its 'nextCmd' is empty */
+static DWPAL_Ret hostapStateSnapshotTake(int idx, HostapState *snapshot, struct timespec *budgetExpiry)
+{
+	char      *reply = (char *)malloc(HOSTAPD_TO_DWPAL_MSG_LENGTH);
+	char      MACAddress[MAC_ADDR_STRING_LENGTH];
+	size_t    replyLen;
+	int       msLeft;
+	DWPAL_Ret ret;
+
+	if (reply == NULL)
+	{
+		console_printf("%s; malloc failed ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	while ( (snapshot->nextCmd[0] != '\0') && ((msLeft = timespecMsLeftGet(budgetExpiry)) > 0) )
+	{
+		replyLen = HOSTAPD_TO_DWPAL_MSG_LENGTH - 1;
+		ret = hostapCmdSend(idx, dwpalService[idx]->VAPName, snapshot->nextCmd, NULL, &reply, &replyLen, false /*isReplyAlloc*/, (unsigned int)msLeft);
+
+		if (ret == DWPAL_TIMEOUT)
+		{  /* hostapd is busy; only a command that was given a whole round's budget counts */
+			if ( (msLeft >= HOSTAP_STATE_ROUND_BUDGET_MS) && (++snapshot->numOfTimeouts >= HOSTAP_STATE_CMD_TIMEOUTS_MAX) )
+			{
+				free((void *)reply);
+				return ret;
+			}
+			break;
+		}
+		snapshot->numOfTimeouts = 0;
+
+		if (!strncmp(snapshot->nextCmd, "GET_RADIO_INFO", sizeof("GET_RADIO_INFO")))
+		{  /* the radio info is optional */
+			if ( (ret == DWPAL_SUCCESS) && (replyLen > 0) && (strncmp(reply, "FAIL", 4)) && (strncmp(reply, "UNKNOWN COMMAND", 15)) )
+			{
+				snapshot->radioInfo = strdup(reply);
+			}
+			snapshot->nextCmd[0] = '\0';
+			continue;
+		}
+
+		if (ret != DWPAL_SUCCESS)
+		{
+			free((void *)reply);
+			return ret;
+		}
+
+		/* The reply starts with the station's MAC address; an empty (or "FAIL") reply ends the list */
+		if ( (replyLen < MAC_ADDR_STRING_LENGTH - 1) || (reply[2] != ':') )
+		{
+			strcpy_s(snapshot->nextCmd, sizeof(snapshot->nextCmd), "GET_RADIO_INFO");
+			continue;
+		}
+
+		strncpy_s(MACAddress, sizeof(MACAddress), reply, MAC_ADDR_STRING_LENGTH - 1);
+		hostapStationAdd(snapshot, MACAddress);
+		snprintf_s(snapshot->nextCmd, sizeof(snapshot->nextCmd), "STA-NEXT %s", MACAddress);
+	}
+
+	free((void *)reply);
+	return DWPAL_SUCCESS;
+}
+
+
+/* Append the lines of 'newText' that are not in 'oldText' (i.e. "Channel=36"), each with the 'prefix' */
+static void hostapStateLinesDiffGet(const char *oldText, const char *newText, const char *prefix, char *diff /*OUT*/, size_t diffSize)
+{
+	const char *line = newText, *lineEnd, *found;
+	size_t     lineLen, diffLen;
+
+	while ( (line != NULL) && (*line != '\0') )
+	{
+		lineEnd = strchr(line, '\n');
+		lineLen = (lineEnd == NULL) ? strnlen_s(line, HOSTAPD_TO_DWPAL_MSG_LENGTH) : (size_t)(lineEnd - line);
+
+		/* A line is the same if found as a whole line in the old text */
+		found = oldText;
+		while (found != NULL)
+		{
+			if ( (!strncmp(found, line, lineLen)) && ((found[lineLen] == '\n') || (found[lineLen] == '\0')) )
+			{
+				break;
+			}
+
+			if ((found = strchr(found, '\n')) != NULL)
+			{
+				found++;
+			}
+		}
+
+		if ( (found == NULL) && (lineLen > 0) )
+		{
+			diffLen = strnlen_s(diff, diffSize);
+			snprintf_s(diff + diffLen, diffSize - diffLen, "%s %.*s\n", prefix, (int)lineLen, line);
+		}
+
+		line = (lineEnd == NULL) ? NULL : lineEnd + 1;
+	}
+}
+
+
+/* Start taking a new snapshot of the interface's state; it is taken by the listener rounds (see hostapStatesSnapshotContinue), for a
+ * large station list not to hold the other interfaces' events back. A snapshot in progress is started over */
+static void hostapStateResync(int idx)
+{
+	HostapState *state = dwpalService[idx]->state;
+
+	if (state == NULL)
+	{
+		return;
+	}
+
+	hostapStateFree(state->snapshot);
+	if ((state->snapshot = (HostapState *)calloc(1, sizeof(HostapState))) == NULL)
+	{
+		console_printf("%s; calloc failed ==> Abort!\n", __FUNCTION__);
+		return;
+	}
+
+	strcpy_s(state->snapshot->nextCmd, sizeof(state->snapshot->nextCmd), "STA-FIRST");
+	isStateSnapshotPending = true;
+}
+
+
+/* The snapshot was taken: it becomes the interface's state, and the diff against the last known state is delivered via
+ * "INTERFACE_STATE_DIFF"; consumers update their state by it, rather than re-query everything from the (i.e. just restarted) hostapd.
+ * The diff is of lines: "STA_ADDED <MAC>", "STA_REMOVED <MAC>", "RADIO_INFO <name>=<value>" (of the changed radio info fields) */
+static void hostapStateSnapshotApply(int idx)
+{
+	HostapState *oldState = dwpalService[idx]->state, *newState = oldState->snapshot;
+	char        *diff;
+	size_t      i, diffLen, diffSize;
+
+	oldState->snapshot = NULL;
+	dwpalService[idx]->state = newState;
+
+	if (oldState->isBaselineNeeded)
+	{  /* nothing is known yet to diff against */
+		hostapStateFree(oldState);
+		return;
+	}
+
+	diffSize = (oldState->numOfStations + newState->numOfStations) * (sizeof("STA_REMOVED ") + MAC_ADDR_STRING_LENGTH) +
+	           ((newState->radioInfo == NULL) ? 0 : (2 * strnlen_s(newState->radioInfo, HOSTAPD_TO_DWPAL_MSG_LENGTH))) + 1;
+	if ((diff = (char *)malloc(diffSize)) == NULL)
+	{
+		console_printf("%s; malloc failed ==> Abort!\n", __FUNCTION__);
+		hostapStateFree(oldState);
+		return;
+	}
+	diff[0] = '\0';
+
+	for (i=0; i < newState->numOfStations; i++)
+	{
+		if (!hostapStationIsFound(oldState, newState->stations[i], NULL))
+		{
+			diffLen = strnlen_s(diff, diffSize);
+			snprintf_s(diff + diffLen, diffSize - diffLen, "STA_ADDED %s\n", newState->stations[i]);
+		}
+	}
+
+	for (i=0; i < oldState->numOfStations; i++)
+	{
+		if (!hostapStationIsFound(newState, oldState->stations[i], NULL))
+		{
+			diffLen = strnlen_s(diff, diffSize);
+			snprintf_s(diff + diffLen, diffSize - diffLen, "STA_REMOVED %s\n", oldState->stations[i]);
+		}
+	}
+
+	if (newState->radioInfo != NULL)
+	{
+		hostapStateLinesDiffGet(oldState->radioInfo, newState->radioInfo, "RADIO_INFO", diff, diffSize);
+	}
+
+	hostapEventDispatch(idx, "INTERFACE_STATE_DIFF", diff, strnlen_s(diff, diffSize));
+
+	free((void *)diff);
+	hostapStateFree(oldState);
+}
+
+
+/* Continue the interfaces' state snapshots, within HOSTAP_STATE_ROUND_BUDGET_MS per round; the first snapshots of the interfaces that
+ * their state tracking was just enabled are started here */
+static void hostapStatesSnapshotContinue(void)
+{
+	struct timespec budgetExpiry;
+	HostapState     *state;
+	bool            isPending = false;
+	int             i;
+
+	clock_gettime(CLOCK_MONOTONIC, &budgetExpiry);
+	timespecAddMs(&budgetExpiry, HOSTAP_STATE_ROUND_BUDGET_MS);
+
+	for (i=0; i < numOfServices; i++)
+	{
+		if ( (dwpalService[i] == NULL) || (context[i] == NULL) || ((state = dwpalService[i]->state) == NULL) ||
+		     (dwpalService[i]->isConnectionEstablishNeeded) )
+		{  /* a snapshot of an interface to be recovered is started over once reconnected */
+			continue;
+		}
+
+		if ( (state->isBaselineNeeded) && (state->snapshot == NULL) )
+		{
+			hostapStateResync(i);
+		}
+
+		if (state->snapshot == NULL)
+		{
+			continue;
+		}
+
+		if (isTimespecExpired(&budgetExpiry))
+		{
+			isPending = true;
+			continue;
+		}
+
+		if (hostapStateSnapshotTake(i, state->snapshot, &budgetExpiry) != DWPAL_SUCCESS)
+		{
+			console_printf("%s; hostapStateSnapshotTake (VAPName= '%s') failed ==> state is not resynced\n", __FUNCTION__, dwpalService[i]->VAPName);
+			hostapStateFree(state->snapshot);
+			state->snapshot = NULL;
+		}
+		else if (state->snapshot->nextCmd[0] == '\0')
+		{
+			hostapStateSnapshotApply(i);
+		}
+		else
+		{
+			isPending = true;
+		}
+	}
+
+	isStateSnapshotPending = isPending;
+}
+
+
+static void interfacesRecoverIfNeeded(void)
+{
+	int  i;
+	DWPAL_Ret ret;
+
+	//console_printf("%s Entry\n", __FUNCTION__);
+
+	for (i=0; i < numOfServices; i++)
+	{
+		/* In case that there is no valid context, continue... */
+		if (dwpalService[i] == NULL)
+		{
+			continue;
+		}
+
+		/* In case of recovery needed, try recover; in case of interface init, try to establish the connection */
+		if ( (!strncmp(dwpalService[i]->interfaceType, "hostap", 7)) &&
+		     (dwpalService[i]->isConnectionEstablishNeeded == true) )
+		{
+			pthread_mutex_lock(&context_mutex);
+			ret = dwpal_hostap_interface_attach(&context[i] /*OUT*/, dwpalService[i]->VAPName,
+			                                    dwpalService[i]->isTwoWay ? hostapTwoWayEventCallback : NULL /*use one-way interface*/);
+			if (ret == DWPAL_SUCCESS)
+			{
+				listenerFdAdd(i);
+
+				if (hostapEventRcvBufSize > 0)
+				{
+					dwpal_hostap_event_rcvbuf_set(context[i], hostapEventRcvBufSize);
+				}
+
+				if (dwpalService[i]->eventLevel != 0)
+				{  /* the restarted hostapd sends all the events again */
+					hostapEventLevelApply(i);
+				}
+			}
+			pthread_mutex_unlock(&context_mutex);
+
+			if (ret == DWPAL_SUCCESS)
+			{
+				console_printf("%s; VAPName= '%s' interface recovered successfully!\n", __FUNCTION__, dwpalService[i]->VAPName);
+				dwpalService[i]->isConnectionEstablishNeeded = false;
+
+				/* Notify via the callback that interface recovered successfully */
+				hostapEventDispatch(i, "INTERFACE_RECONNECTED_OK", NULL, 0);
+
+				hostapStateResync(i);
+			}
+		}
+	}
+}
+
+
+static void interfaceRecoveryNeededSet(int idx)
+{
+	console_printf("%s; VAPName= '%s' interface needs to be recovered\n", __FUNCTION__, dwpalService[idx]->VAPName);
+
+	dwpalService[idx]->isConnectionEstablishNeeded = true;
+	listenerFdRemove(idx);
+	dwpalService[idx]->backlogEvents = 0;
+	dwpalService[idx]->backlogRounds = 0;
+	dwpalService[idx]->isResyncNeeded = false;  /* the reconnection is notified instead */
+
+	/* Cached replies of the lost hostapd instance are not valid anymore */
+	pthread_mutex_lock(&cache_mutex);
+	cmdCacheEntriesRemove(dwpalService[idx]->VAPName, false /*isExpiredOnly*/);
+	pthread_mutex_unlock(&cache_mutex);
+
+	pthread_mutex_lock(&context_mutex);
+	/* Close 'wpaCtrlPtr', and free 'context' */
+	if (context[idx] != NULL && dwpal_hostap_interface_detach(&context[idx]) == DWPAL_FAILURE)
+	{
+		console_printf("%s; dwpal_hostap_interface_detach (VAPName= '%s') returned ERROR ==> cont...\n", __FUNCTION__, dwpalService[idx]->VAPName);
+	}
+	pthread_mutex_unlock(&context_mutex);
+}
+
+
+/* PINGs are sent without waiting; their PONGs are collected by the listener (via dwpal_hostap_event_get), and checked on the next round.
+ * Interfaces that recently delivered events or replies are known to be alive, and are not pinged (unless 'isForced') */
+/* A busy hostapd (i.e. in a scan, or with a long command) is covered by the several PING deadlines, rather than by a long one; a
+ * shorter command deadline (see dwpal_ext_hostap_cmd_timeout_set) shortens it too */
+static unsigned int hostapPingTimeoutGet(void)
+{
+	unsigned int cmdTimeoutMs = (hostapCmdTimeoutMs == 0) ? DWPAL_HOSTAPD_CMD_TIMEOUT_MS : hostapCmdTimeoutMs;
+
+	return (cmdTimeoutMs < PONG_TIMEOUT_MS) ? cmdTimeoutMs : PONG_TIMEOUT_MS;
+}
+
+
+static void interfacesPingCheck(bool isForced)
+{
+	int          i;
+	unsigned int idleMs, pingPendingMs, numOfMissedPongs;
+	DWPAL_Ret    ret;
+
+	//console_printf("%s Entry\n", __FUNCTION__);
+
+	for (i=0; i < numOfServices; i++)
+	{
+		/* In case that there is no valid context, continue... */
+		if ( (context[i] == NULL) || (dwpalService[i] == NULL) )
+		{
+			continue;
+		}
+
+		if ( (!strncmp(dwpalService[i]->interfaceType, "hostap", sizeof("hostap") - 1)) && (dwpalService[i]->fd > 0) )
+		{
+			/* Two-way interfaces send the PING on the command socket */
+			numOfMissedPongs = 0;
+			pthread_mutex_lock(&context_mutex);
+			ret = dwpal_hostap_liveness_get(context[i], &idleMs /*OUT*/, &pingPendingMs /*OUT*/);
+			if (ret == DWPAL_SUCCESS)
+			{
+				numOfMissedPongs = pingPendingMs / hostapPingTimeoutGet();
+
+				if ( ((pingPendingMs == 0) && ((isForced) || (idleMs >= PING_CHECK_TIME * 1000))) ||
+				     ((numOfMissedPongs > dwpalService[i]->numOfMissedPongs) && (numOfMissedPongs < PING_MISSED_PONGS_MAX)) )
+				{  /* a PING that passed its deadline is re-sent, in case that it was lost */
+					ret = dwpal_hostap_ping_send(context[i]);
+				}
+				dwpalService[i]->numOfMissedPongs = numOfMissedPongs;
+			}
+			pthread_mutex_unlock(&context_mutex);
+
+			/* check if interface that should exist, still exists; a hung hostapd is as good as a dead one */
+			if ( (ret == DWPAL_FAILURE) || (numOfMissedPongs >= PING_MISSED_PONGS_MAX) )
+			{
+				console_printf("%s; VAPName= '%s' is not alive (ret= %d, numOfMissedPongs= %u)\n", __FUNCTION__, dwpalService[i]->VAPName, ret, numOfMissedPongs);
+				dwpalService[i]->numOfMissedPongs = 0;
+				interfaceRecoveryNeededSet(i);
+			}
+		}
+	}
+}
+
+
+static unsigned int hostapEventQueueLimitGet(void)
+{
+	FILE         *fp = fopen(UNIX_DGRAM_QUEUE_LIMIT_FILE, "r");
+	unsigned int limit = 0;
+
+	if (fp != NULL)
+	{
+		if (fscanf(fp, "%u", &limit) != 1)
+		{
+			limit = 0;
+		}
+		fclose(fp);
+	}
+
+	return (limit > 0) ? limit : UNIX_DGRAM_DEFAULT_QUEUE_LIMIT;
+}
+
+
+/* The listener drains the event socket of a ready interface, up to HOSTAP_EVENT_DRAIN_BUDGET events per round. A burst that merely
+ * fills the queue once is not a loss; only an event socket that is left full round after round (a full queue received, and still
+ * not found empty) for HOSTAP_EVENT_OVERFLOW_ROUNDS consecutive rounds is suspected to have made hostapd fail sending it events -
+ * and, if failed too often, detach it.
+ * Once the backlog is cleared, the event socket is re-attached, and the callback is asked to resync via "EVENTS_RESYNC_NEEDED" */
+static void hostapEventBacklogCheck(int idx, unsigned int numOfEvents, bool isDrained)
+{
+	unsigned int fullRoundEvents = (hostapEventQueueLimit < HOSTAP_EVENT_DRAIN_BUDGET) ? hostapEventQueueLimit : HOSTAP_EVENT_DRAIN_BUDGET;
+	bool         isDetached = false;
+	DWPAL_Ret    ret;
+
+	dwpalService[idx]->backlogEvents += numOfEvents;
+
+	if (!isDrained)
+	{
+		if (numOfEvents >= fullRoundEvents)
+		{
+			dwpalService[idx]->backlogRounds++;
+			if ( (dwpalService[idx]->backlogRounds == HOSTAP_EVENT_OVERFLOW_ROUNDS) &&
+			     (dwpalService[idx]->backlogEvents >= hostapEventQueueLimit) )
+			{
+				console_printf("%s; VAPName= '%s' event socket overflow suspected\n", __FUNCTION__, dwpalService[idx]->VAPName);
+				hostapEventStatsAdd(&dwpalService[idx]->eventStats.numOfOverflows);
+				dwpalService[idx]->isResyncNeeded = true;
+			}
+		}
+
+		return;
+	}
+
+	dwpalService[idx]->backlogEvents = 0;
+	dwpalService[idx]->backlogRounds = 0;
+
+	if (!dwpalService[idx]->isResyncNeeded)
+	{
+		return;
+	}
+
+	dwpalService[idx]->isResyncNeeded = false;
+
+	pthread_mutex_lock(&context_mutex);
+	cmdServiceIdx = idx;  /* for two-way interfaces' events, received while waiting for the reply */
+	ret = dwpal_hostap_event_reattach(context[idx], &isDetached /*OUT*/);
+	cmdServiceIdx = -1;
+	if ( (ret == DWPAL_SUCCESS) && (dwpalService[idx]->eventLevel != 0) )
+	{
+		hostapEventLevelApply(idx);
+	}
+	pthread_mutex_unlock(&context_mutex);
+
+	if (ret != DWPAL_SUCCESS)
+	{  /* the reconnection is notified instead */
+		interfaceRecoveryNeededSet(idx);
+		return;
+	}
+
+	if (isDetached)
+	{
+		console_printf("%s; VAPName= '%s' event socket was detached by hostapd ==> re-attached\n", __FUNCTION__, dwpalService[idx]->VAPName);
+		hostapEventStatsAdd(&dwpalService[idx]->eventStats.numOfMonitorDetaches);
+	}
+
+	hostapEventStatsAdd(&dwpalService[idx]->eventStats.numOfResyncs);
+	hostapEventDispatch(idx, "EVENTS_RESYNC_NEEDED", "", 0);
+
+	/* The lost station events are covered by the diff */
+	hostapStateResync(idx);
+}
+
+
+/* Deliver a queued event to its callback, unless the interface was detached since the event was received. The callback is called with
+ * 'services_lock' unlocked, for a slow callback not to hold the attach/detach and the settings back */
+static void eventDataDeliver(EventData *eventData)
+{
+	DwpalService                     *service;
+	DwpalExtHostapEventCallback      hostapEventCallback = NULL;
+	DwpalExtNlEventCallback          nlEventCallback = NULL;
+	DwpalExtNlNonVendorEventCallback nlNonVendorEventCallback = NULL;
+
+	pthread_rwlock_rdlock(&services_lock);
+
+	service = (eventData->serviceIdx < numOfServices) ? dwpalService[eventData->serviceIdx] : NULL;
+
+	switch (eventData->type)
+	{
+		case EVENT_TYPE_HOSTAP:
+			if ( (service != NULL) && (!strncmp(service->VAPName, eventData->VAPName, sizeof(eventData->VAPName))) &&
+			     ((!eventData->isBounded) || (hostapEventQueueRelease(&service->queueBound, eventData))) )
+			{
+				hostapEventCallback = service->hostapEventCallback;
+			}
+			break;
+
+		case EVENT_TYPE_NL_VENDOR:
+			if ( (service != NULL) && (!strncmp(service->interfaceType, "Driver", 7)) )
+			{
+				nlEventCallback = service->nlEventCallback;
+			}
+			break;
+
+		case EVENT_TYPE_NL_NON_VENDOR:
+			if ( (service != NULL) && (!strncmp(service->interfaceType, "Driver", 7)) )
+			{
+				nlNonVendorEventCallback = service->nlNonVendorEventCallback;
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	pthread_rwlock_unlock(&services_lock);
+
+	/* The VAP name and the message are the event's own copies */
+	if (hostapEventCallback != NULL)
+	{
+		hostapEventCallback(eventData->VAPName, eventData->opCode, eventData->msg, eventData->msgStringLen);
+	}
+	else if (nlEventCallback != NULL)
+	{
+		nlEventCallback(eventData->VAPName, eventData->event, eventData->subevent, eventData->msgStringLen, (unsigned char *)eventData->msg);
+	}
+	else if (nlNonVendorEventCallback != NULL)
+	{
+		nlNonVendorEventCallback(eventData->nlMsg);
+	}
+}
+
+
+static void *callbackWorkerThreadStart(void *temp)
+{
+	CallbackWorker *worker = (CallbackWorker *)temp;
+	EventData      eventData;
+
+	console_printf("%s Entry\n", __FUNCTION__);
+
+	/* Receive the msg */
+	while (true)
+	{
+		if ( (sem_wait(&worker->sem) != 0) && (errno != EINTR) )
+		{
+			console_printf("%s; sem_wait() fail; errno= %d ('%s') ==> cont...\n", __FUNCTION__, errno, strerror(errno));
+		}
+
+		if (!eventQueueGet(worker, &eventData /*OUT*/))
+		{
+			if (worker->shouldStop)
+			{
+				console_printf("%s; received message from main thread => shutting down\n", __FUNCTION__);
+				break;
+			}
+
+			continue;
+		}
+
+		eventDataDeliver(&eventData);
+		eventDataRelease(&eventData);
+	}
+
+	return NULL;
+}
+
+
+static const char *hostapSocketDirs[] = { "hostapd", "wpa_supplicant" };  /* under HOSTAP_SOCKET_DIRS_PARENT */
+
+
+/* Watch the hostapd/supplicant control sockets' directories (that may not exist yet) */
+static void hostapSocketDirsWatchAdd(int inotifyFd)
+{
+	size_t i;
+	char   dirName[DWPAL_WPA_CTRL_STRING_LENGTH];
+
+	for (i=0; i < sizeof(hostapSocketDirs) / sizeof(hostapSocketDirs[0]); i++)
+	{
+		snprintf_s(dirName, sizeof(dirName), "%s/%s", HOSTAP_SOCKET_DIRS_PARENT, hostapSocketDirs[i]);
+
+		/* Adding an already watched directory just returns its existing watch */
+		if ( (inotify_add_watch(inotifyFd, dirName, IN_CREATE | IN_MOVED_TO | IN_DELETE | IN_ONLYDIR) < 0) && (errno != ENOENT) )
+		{
+			console_printf("%s; inotify_add_watch ('%s') ERROR (errno= %d) ==> cont...\n", __FUNCTION__, dirName, errno);
+		}
+	}
+}
+
+
+static int hostapSocketWatchCreate(void)
+{
+	int inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+	if (inotifyFd < 0)
+	{
+		console_printf("%s; inotify_init1 ERROR (errno= %d) ==> fallback to polling\n", __FUNCTION__, errno);
+		return -1;
+	}
+
+	/* Watch the parent as well, in order to catch the creation of the directories themselves */
+	if (inotify_add_watch(inotifyFd, HOSTAP_SOCKET_DIRS_PARENT, IN_CREATE | IN_MOVED_TO | IN_ONLYDIR) < 0)
+	{
+		console_printf("%s; inotify_add_watch ('%s') ERROR (errno= %d) ==> cont...\n", __FUNCTION__, HOSTAP_SOCKET_DIRS_PARENT, errno);
+	}
+
+	hostapSocketDirsWatchAdd(inotifyFd);
+
+	return inotifyFd;
+}
+
+
+/* Returns true if a control socket of a registered interface appeared/disappeared */
+static bool hostapSocketWatchHandle(int inotifyFd)
+{
+	int     i;
+	bool    isInterfaceChanged = false;
+	ssize_t len;
+	char    *p2event;
+	char    buf[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+	const struct inotify_event *event;
+
+	while ((len = read(inotifyFd, buf, sizeof(buf))) > 0)
+	{
+		for (p2event = buf; p2event < buf + len; p2event += sizeof(struct inotify_event) + event->len)
+		{
+			event = (const struct inotify_event *)p2event;
+
+			if (event->len == 0)
+			{
+				continue;
+			}
+
+			if (event->mask & IN_ISDIR)
+			{  /* one of the sockets' directories was created; watch it, and look for sockets created before the watch */
+				hostapSocketDirsWatchAdd(inotifyFd);
+				isInterfaceChanged = true;
+				continue;
+			}
+
+			if (interfaceIndexGet("hostap", (char *)event->name, &i) == DWPAL_SUCCESS)
+			{
+				console_printf("%s; VAPName= '%s' control socket %s\n", __FUNCTION__, event->name, (event->mask & IN_DELETE) ? "removed" : "created");
+				isInterfaceChanged = true;
+			}
+		}
+	}
+
+	return isInterfaceChanged;
+}
+
+
+/* Receive, and handle, the pending events of a ready hostap interface, until its event socket is drained (or the budget is used up);
+ * called by the listener thread with 'services_lock' locked for read. Returns false in case of a receive error, for the recovery
+ * check to be performed right away */
+static bool hostapEventsReceive(int idx)
+{
+	int          ret = DWPAL_SUCCESS;
+	unsigned int numOfEvents;
+	bool         isDrained = false, isStalled = false;
+	char         *msg;
+	size_t       msgLen, msgStringLen;
+	char         opCode[64];
+
+	/*console_printf("%s; event received; interfaceType= '%s', VAPName= '%s'\n",
+	       __FUNCTION__, dwpalService[idx]->interfaceType, dwpalService[idx]->VAPName);*/
+
+	for (numOfEvents=0; numOfEvents < HOSTAP_EVENT_DRAIN_BUDGET; numOfEvents++)
+	{
+		msg = NULL;
+
+		/* A two-way socket is shared with the command sends; don't take their replies. It is locked per event, for a pending
+		 * command not to wait for the whole burst */
+		if (dwpalService[idx]->isTwoWay)
+		{
+			pthread_mutex_lock(&context_mutex);
+		}
+
+		/* Unsubscribed events are dropped in the socket, before they are sized, allocated for, and copied */
+		if (hostapEventUnsubscribedDiscard(idx))
+		{
+			ret = DWPAL_NO_PENDING_MESSAGES;
+		}
+		else
+		{
+			/* Size the event first, so that large events (i.e. with long 'assoc_req' IEs) are received complete */
+			ret = dwpal_hostap_event_len_get(context[idx], &msgLen /*OUT*/);
+			if (ret == DWPAL_NO_PENDING_MESSAGES)
+			{
+				isDrained = true;
+			}
+			else
+			{
+				if (ret != DWPAL_SUCCESS)
+				{
+					msgLen = HOSTAPD_TO_DWPAL_MSG_LENGTH - 1;
+				}
+
+				msg = eventBufferGet((msgLen + 1) * sizeof(char));
+				if (msg == NULL)
+				{
+					console_printf("%s; invalid input ('msg') parameter ==> cont...\n", __FUNCTION__);
+					hostapEventStatsAdd(&dwpalService[idx]->eventStats.numOfDroppedEvents);
+					ret = DWPAL_NO_PENDING_MESSAGES;
+					isStalled = true;  /* the event is left in the socket, for the next round */
+				}
+				else
+				{
+					/* dwpal_hostap_event_get() NULL terminates the received event; a PONG (or a late reply) is received as
+					 * DWPAL_NO_PENDING_MESSAGES */
+					opCode[0] = '\0';
+					ret = dwpal_hostap_event_get(context[idx], msg /*OUT*/, &msgLen /*IN/OUT*/, opCode /*OUT*/);
+				}
+			}
+		}
+
+		if (dwpalService[idx]->isTwoWay)
+		{
+			pthread_mutex_unlock(&context_mutex);
+		}
+
+		if ( (isDrained) || (isStalled) )
+		{
+			break;
+		}
+
+		if (ret == DWPAL_FAILURE)
+		{
+			console_printf("%s; dwpal_hostap_event_get ERROR; VAPName= '%s', msgLen= %d\n",
+			       __FUNCTION__, dwpalService[idx]->VAPName, (int)msgLen);
+			if (msg != NULL)
+			{
+				eventBufferRelease(msg);
+			}
+			return false;
+		}
+		else if (ret == DWPAL_SUCCESS)
+		{
+			//console_printf("%s; msgLen= %d, msg= '%s'\n", __FUNCTION__, msgLen, msg);
+//strcpy(msg, "<3>AP-STA-CONNECTED wlan0 24:77:03:80:5d:90 SignalStrength=-49 SupportedRates=2 4 11 22 12 18 24 36 48 72 96 108 HT_CAP=107E HT_MCS=FF FF FF 00 00 00 00 00 00 00 C2 01 01 00 00 00 VHT_CAP=03807122 VHT_MCS=FFFA 0000 FFFA 0000 btm_supported=1 nr_enabled=0 non_pref_chan=81:200:1:7 non_pref_chan=81:100:2:9 non_pref_chan=81:200:1:7 non_pref_chan=81:100:2:5 cell_capa=1 assoc_req=00003A01000A1B0E04606C722002E833000A1B0E0460C04331060200000E746573745F737369645F69736172010882848B960C12182432043048606C30140100000FAC040100000FAC040100000FAC020000DD070050F2020001002D1AEF1903FFFFFF00000000000000000000000000000018040109007F080000000000000040BF0CB059C103EAFF1C02EAFF1C02C70122");
+//strcpy(msg, "<3>AP-STA-DISCONNECTED wlan0 14:d6:4d:ac:36:70");
+//strcpy(opCode, "AP-STA-CONNECTED");
+
+			msgStringLen = strnlen_s(msg, msgLen + 1);
+			//console_printf("%s; opCode= '%s', msg= '%s'\n", __FUNCTION__, opCode, msg);
+			if (strncmp(opCode, "", 1))
+			{
+				hostapEventHandle(idx, opCode, msg, msgStringLen);
+			}
+		}
+
+		if (msg != NULL)
+		{
+			eventBufferRelease(msg);
+		}
+	}
+
+	/* A socket that was not drained stays ready, and is continued on the next round */
+	if (context[idx] != NULL)
+	{
+		hostapEventBacklogCheck(idx, numOfEvents, isDrained);
+	}
+
+	return true;
+}
+
+
+/* Add the listener's own fds into the epoll set; the services' fds are added/removed by their attach/detach (see listenerFdAdd) */
+static DWPAL_Ret listenerSetUp(void)
+{
+	/* Attach as soon as a control socket appears, instead of polling for it */
+	listenerInotifyFd = hostapSocketWatchCreate();
+
+	hostapEventQueueLimit = hostapEventQueueLimitGet();
+
+	listenerLastPingCheck = listenerLastRecoveryTime = time(NULL);
+
+	pthread_rwlock_wrlock(&services_lock);
+	listenerEpollFdAdd(LISTENER_EPOLL_PIPE, listenerThreadPipeFds[0]);
+	if (listenerInotifyFd >= 0)
+	{
+		listenerEpollFdAdd(LISTENER_EPOLL_INOTIFY, listenerInotifyFd);
+	}
+	pthread_rwlock_unlock(&services_lock);
+
+	if (listenerEpollFd < 0)
+	{
+		console_printf("%s; no epoll instance ==> Abort!\n", __FUNCTION__);
+		if (listenerInotifyFd >= 0)
+		{
+			close(listenerInotifyFd);
+			listenerInotifyFd = -1;
+		}
+		return DWPAL_FAILURE;
+	}
+
+	return DWPAL_SUCCESS;
+}
+
+
+static void listenerTearDown(void)
+{
+	pthread_rwlock_wrlock(&services_lock);
+	listenerEpollFdRemove(listenerThreadPipeFds[0]);
+	if (listenerInotifyFd >= 0)
+	{
+		listenerEpollFdRemove(listenerInotifyFd);
+		close(listenerInotifyFd);
+		listenerInotifyFd = -1;
+	}
+	pthread_rwlock_unlock(&services_lock);
+}
+
+
+/* Move the ready driver fds ahead of the hostap ones, for the driver's (i.e. radar) events not to wait behind the hostap events' drains;
+ * called with 'services_lock' locked for read */
+static void listenerEventsPrioritize(struct epoll_event *events, int numOfEvents)
+{
+	int                i, numOfFirst = 0, idx;
+	struct epoll_event temp;
+
+	for (i=0; i < numOfEvents; i++)
+	{
+		idx = (int)(events[i].data.u64 & 0xFFFFFFFF) - LISTENER_EPOLL_SERVICE_BASE;
+
+		if ( (idx >= 0) && (idx < numOfServices) && (dwpalService[idx] != NULL) &&
+		     (!strncmp(dwpalService[idx]->interfaceType, "Driver", 7)) )
+		{
+			if (i != numOfFirst)
+			{
+				temp = events[numOfFirst];
+				events[numOfFirst] = events[i];
+				events[i] = temp;
+			}
+			numOfFirst++;
+		}
+	}
+}
+
+
+/* Wait up to 'timeoutMs' for the ready fds, and handle them, along with the PING checks and the recovery (that are due once a second);
+ * run by the listener thread, or by the caller's loop via dwpal_ext_dispatch. Returns false once the listener thread is told to stop */
+static bool listenerRoundRun(int timeoutMs)
+{
+	int     i, numOfEvents, ret, fd;
+	bool    isInterfacesPingCheck = false, isInterfacesRecover = false;
+	struct  epoll_event events[LISTENER_EPOLL_MAX_EVENTS];
+	time_t  current_time;
+
+	/* A state snapshot in progress is continued right away */
+	if (isStateSnapshotPending)
+	{
+		timeoutMs = 0;
+	}
+
+	/* Wake up in time for the held events' coalescing windows */
+	if (isCoalescedEventPending)
+	{
+		int msLeft = timespecMsLeftGet(&coalescedEventNextExpiry);
+
+		if ( (timeoutMs < 0) || (msLeft < timeoutMs) )
+		{
+			timeoutMs = msLeft;
+		}
+	}
+
+	numOfEvents = epoll_wait(listenerEpollFd, events, LISTENER_EPOLL_MAX_EVENTS, timeoutMs);
+	if (numOfEvents < 0)
+	{
+		if (errno != EINTR)
+		{
+			console_printf("%s; epoll_wait() return value= %d ==> cont...; errno= %d ('%s')\n", __FUNCTION__, numOfEvents, errno, strerror(errno));
+		}
+		return true;
+	}
+
+	for (i=0; i < numOfEvents; i++)
+	{
+		if (events[i].data.u64 == listenerEpollDataGet(LISTENER_EPOLL_PIPE, listenerThreadPipeFds[0]))
+		{
+			char pipedMsg[16];
+
+			pthread_mutex_lock(&deferred_mutex);
+			if ((ret = read(listenerThreadPipeFds[0], pipedMsg, sizeof(pipedMsg))) < 0)
+			{
+				console_printf("%s; read() return value= %d ==> cont...; errno= %d ('%s')\n", __FUNCTION__, ret, errno, strerror(errno));
+			}
+			isListenerWakeupPending = false;
+			pthread_mutex_unlock(&deferred_mutex);
+		}
+	}
+
+	if (listenerThreadShouldStop)
+	{
+		console_printf("%s; received message from main thread => shutting down\n", __FUNCTION__);
+		return false;
+	}
+
+	pthread_rwlock_rdlock(&services_lock);
+
+	deferredEventsDispatch();
+	coalescedEventsFlush();
+	listenerEventsPrioritize(events, numOfEvents);
+
+	for (i=0; i < numOfEvents; i++)
+	{
+		unsigned int tag = (unsigned int)(events[i].data.u64 & 0xFFFFFFFF);
+		int          idx = (int)tag - LISTENER_EPOLL_SERVICE_BASE;
+
+		fd = (int)(events[i].data.u64 >> 32);
+
+		if (tag == LISTENER_EPOLL_INOTIFY)
+		{
+			if (hostapSocketWatchHandle(listenerInotifyFd))
+			{
+				/* A restarted hostapd re-creates its socket: detect the dead connection, and reconnect, right away */
+				isInterfacesPingCheck = true;
+				isInterfacesRecover = true;
+			}
+			continue;
+		}
+
+		/* The service may have been detached (or its index re-used) since epoll_wait() reported it */
+		if ( (tag < LISTENER_EPOLL_SERVICE_BASE) || (idx >= numOfServices) ||
+		     (context[idx] == NULL) || (dwpalService[idx] == NULL) || (dwpalService[idx]->fd != fd) )
+		{
+			continue;
+		}
+
+		if (!strncmp(dwpalService[idx]->interfaceType, "hostap", 7))
+		{
+			if (!hostapEventsReceive(idx))
+			{
+				/* Trigger the recovery check/perform immediately */
+				isInterfacesPingCheck = true;
+			}
+		}
+		else if (!strncmp(dwpalService[idx]->interfaceType, "Driver", 7))
+		{
+			console_printf("%s; event received; interfaceType= '%s', VAPName= '%s'\n",
+				   __FUNCTION__, dwpalService[idx]->interfaceType, dwpalService[idx]->VAPName);
+
+			/* In case of callback workers, the events are queued to them (by their interface) */
+			if (dwpal_driver_nl_msg_get(context[idx], DWPAL_NL_UNSOLICITED_EVENT,
+			                            ((numOfCallbackWorkers > 0) && (dwpalService[idx]->nlEventCallback != NULL)) ?
+			                            nlEventQueue : dwpalService[idx]->nlEventCallback,
+			                            ((numOfCallbackWorkers > 0) && (dwpalService[idx]->nlNonVendorEventCallback != NULL)) ?
+			                            nlNonVendorEventQueue : dwpalService[idx]->nlNonVendorEventCallback) == DWPAL_FAILURE)
+			{
+				console_printf("%s; dwpal_driver_nl_msg_get ERROR\n", __FUNCTION__);
+			}
+		}
+	}
+
+	/* After the ready events, for their (i.e. radar) delivery not to wait behind the snapshots' commands */
+	hostapStatesSnapshotContinue();
+
+	current_time = time(NULL);
+	/* Cheap when no PING is due: the interfaces' activity is examined, and sockets are touched only when needed */
+	if ( (isInterfacesPingCheck) || (current_time != listenerLastPingCheck) )
+	{
+		listenerLastPingCheck = current_time;
+		interfacesPingCheck(isInterfacesPingCheck);
+	}
+
+	if ( (isInterfacesRecover) ||
+	     ((current_time - listenerLastRecoveryTime) >= ((listenerInotifyFd >= 0) ? RECOVERY_FALLBACK_RETRY_TIME : RECOVERY_RETRY_TIME)) )
+	{
+		listenerLastRecoveryTime = current_time;
+		interfacesRecoverIfNeeded();
+	}
+
+	pthread_rwlock_unlock(&services_lock);
+
+	return true;
+}
+
+
+static void *listenerThreadStart(void *temp)
+{
+	(void)temp;
+
+	console_printf("%s Entry\n", __FUNCTION__);
+
+	if (listenerSetUp() != DWPAL_SUCCESS)
+	{
+		return NULL;
+	}
+
+	/* Receive the msg; released once a second, for the PING checks and the recovery */
+	while ( (!listenerThreadShouldStop) && (listenerRoundRun(1000)) );
+
+	listenerTearDown();
+
+	console_printf("%s; exit\n", __FUNCTION__);
+	return NULL;
+}
+
+
+static DWPAL_Ret listenerThreadPipeOpen(void)
+{
+	int ret;
+
+	pthread_mutex_lock(&deferred_mutex);
+	ret = pipe(listenerThreadPipeFds);
+	isListenerWakeupPending = false;
+	pthread_mutex_unlock(&deferred_mutex);
+	if (ret == -1)
+	{
+		console_printf("%s; pipe ERROR (errno= %d) ==> Abort!\n", __FUNCTION__, errno);
+		listenerThreadPipeFds[0] = listenerThreadPipeFds[1] = -1;
+		return DWPAL_FAILURE;
+	}
+
+	return DWPAL_SUCCESS;
+}
+
+
+static void listenerThreadPipeClose(void)
+{
+	pthread_mutex_lock(&deferred_mutex);
+
+	if (close(listenerThreadPipeFds[0]) != 0)
+	{
+		console_printf("%s; close() to listenerThreadPipeFds[0] FAILED (errno= %d)\n", __FUNCTION__, errno);
+	}
+	if (close(listenerThreadPipeFds[1]) != 0)
+	{
+		console_printf("%s; close() to listenerThreadPipeFds[1] FAILED (errno= %d)\n", __FUNCTION__, errno);
+	}
+
+	listenerThreadPipeFds[0] = listenerThreadPipeFds[1] = -1;
+
+	pthread_mutex_unlock(&deferred_mutex);
+}
+
+
+/* Apply the configured attributes of the thread type to the attributes object */
+static DWPAL_Ret threadAttrApply(pthread_attr_t *attr, DwpalExtThreadAttr *config, bool isSchedApplied)
+{
+	int                ret, cpu;
+	cpu_set_t          cpuSet;
+	struct sched_param schedParam;
+
+	if ( (config->stackSize > 0) && ((ret = pthread_attr_setstacksize(attr, config->stackSize)) != 0) )
+	{
+		console_printf("%s; pthread_attr_setstacksize (%d bytes) ERROR (ret= %d) ==> Abort!\n", __FUNCTION__, (int)config->stackSize, ret);
+		return DWPAL_FAILURE;
+	}
+
+	if (config->cpuMask != 0)
+	{
+		CPU_ZERO(&cpuSet);
+		for (cpu=0; cpu < 64; cpu++)
+		{
+			if (config->cpuMask & (1ULL << cpu))
+			{
+				CPU_SET(cpu, &cpuSet);
+			}
+		}
+
+		if ((ret = pthread_attr_setaffinity_np(attr, sizeof(cpuSet), &cpuSet)) != 0)
+		{
+			console_printf("%s; pthread_attr_setaffinity_np ERROR (ret= %d) ==> Abort!\n", __FUNCTION__, ret);
+			return DWPAL_FAILURE;
+		}
+	}
+
+	if ( (isSchedApplied) && (config->schedPolicy != SCHED_OTHER) )
+	{
+		schedParam.sched_priority = config->schedPriority;
+
+		if ( ((ret = pthread_attr_setinheritsched(attr, PTHREAD_EXPLICIT_SCHED)) != 0) ||
+		     ((ret = pthread_attr_setschedpolicy(attr, config->schedPolicy)) != 0) ||
+		     ((ret = pthread_attr_setschedparam(attr, &schedParam)) != 0) )
+		{
+			console_printf("%s; scheduling (policy= %d, priority= %d) ERROR (ret= %d) ==> Abort!\n",
+			               __FUNCTION__, config->schedPolicy, config->schedPriority, ret);
+			return DWPAL_FAILURE;
+		}
+	}
+
+	return DWPAL_SUCCESS;
+}
+
+
+static DWPAL_Ret listenerThreadCreate(pthread_t *thread_id, ThreadEntryFunc threadEntryFunc, void *arg)
+{
+	int                ret;
+	DWPAL_Ret          dwpalRet = DWPAL_SUCCESS;
+	pthread_attr_t     attr;
+	DwpalExtThreadAttr *config;
+	char               name[sizeof(config->name)];
+	//void           *res;
+
+	console_printf("%s Entry\n", __FUNCTION__);
+
+	ret = pthread_attr_init(&attr);
+	if (ret != 0)
+	{
+		console_printf("%s; pthread_attr_init ERROR (ret= %d) ==> Abort!\n", __FUNCTION__, ret);
+		return DWPAL_FAILURE;
+	}
+
+	/* The callback workers are woken up (and stopped) via their queue's semaphore */
+	if (thread_id == &listenerThreadId)
+	{
+		if (listenerThreadPipeOpen() != DWPAL_SUCCESS)
+		{
+			pthread_attr_destroy(&attr);
+			return DWPAL_FAILURE;
+		}
+
+		listenerThreadShouldStop = 0; /* must be 0 before creating the listener Thread */
+
+		config = &threadAttr[DWPAL_EXT_THREAD_LISTENER];
+		strncpy_s(name, sizeof(name), config->name, sizeof(name) - 1);
+	}
+	else
+	{
+		config = &threadAttr[DWPAL_EXT_THREAD_CALLBACK_WORKER];
+		name[0] = '\0';
+		if (config->name[0] != '\0')
+		{
+			snprintf_s(name, sizeof(name), "%.12s%d", config->name, (int)(thread_id - callbackWorkerThreadIds));
+		}
+	}
+
+	dwpalRet = threadAttrApply(&attr, config, true /*isSchedApplied*/);
+
+	if (dwpalRet == DWPAL_SUCCESS)
+	{
+		console_printf("%s; call pthread_create\n", __FUNCTION__);
+		ret = pthread_create(thread_id, &attr, threadEntryFunc, arg);
+		if ( (ret == EPERM) && (config->schedPolicy != SCHED_OTHER) )
+		{  /* the process is not allowed a real-time scheduling; better run with the default one than not at all */
+			console_printf("%s; real-time scheduling not permitted ==> created with the default scheduling\n", __FUNCTION__);
+			pthread_attr_destroy(&attr);
+			pthread_attr_init(&attr);
+			threadAttrApply(&attr, config, false /*isSchedApplied*/);
+			ret = pthread_create(thread_id, &attr, threadEntryFunc, arg);
+		}
+
+		if (ret != 0)
+		{
+			console_printf("%s; pthread_create ERROR (ret= %d) ==> Abort!\n", __FUNCTION__, ret);
+			dwpalRet = DWPAL_FAILURE;
+		}
+		console_printf("%s; return from call pthread_create, ret= %d\n", __FUNCTION__, ret);
+
+		if (dwpalRet == DWPAL_SUCCESS)
+		{
+			if ( (name[0] != '\0') && ((ret = pthread_setname_np(*thread_id, name)) != 0) )
+			{
+				console_printf("%s; pthread_setname_np ('%s') ERROR (ret= %d) ==> cont...\n", __FUNCTION__, name, ret);
+			}
+
+#if 0
+			/* Causing the thread to be joined with the main process;
+			   meaning, the process will suspend due to the thread suspend.
+			   Otherwise, when process ends, the thread ends as well (although it is suspended and waiting ) */
+			ret = pthread_join(*thread_id, &res);
+			if (ret != 0)
+			{
+				console_printf("%s; pthread_join ERROR (ret= %d) ==> Abort!\n", __FUNCTION__, ret);
+				dwpalRet = DWPAL_FAILURE;
+			}
+
+			free(res);  /* Free memory allocated by thread */
+#endif
+		}
+	}
+
+	if ( (dwpalRet != DWPAL_SUCCESS) && (thread_id == &listenerThreadId) )
+	{
+		listenerThreadPipeClose();
+	}
+
+	/* Destroy the thread attributes object, since it is no longer needed */
+	ret = pthread_attr_destroy(&attr);
+	if (ret != 0)
+	{
+		console_printf("%s; pthread_attr_destroy ERROR (ret= %d) ==> Abort!\n", __FUNCTION__, ret);
+		dwpalRet = DWPAL_FAILURE;
+	}
+
+	return dwpalRet;
+}
+
+
+static DWPAL_Ret threadSet(pthread_t *thread_id, DwpalThreadOperation threadOperation, ThreadEntryFunc threadEntryFunc)
+{
+	int ret;
+
+	switch (threadOperation)
+	{
+		case THREAD_CREATE:
+			if (*thread_id == 0)
+			{
+				if (threadEntryFunc == NULL)
+				{
+					return DWPAL_FAILURE;
+				}
+
+				return listenerThreadCreate(thread_id, threadEntryFunc, NULL);
+			}
+			break;
+
+		case THREAD_CANCEL:
+			if (*thread_id != 0)
+			{
+				/* tell the listener Thread to stop, both with flag, and message */
+				listenerThreadShouldStop = 1;
+				if (write(listenerThreadPipeFds[1], "CANCEL", sizeof("CANCEL")) < 0)
+				{
+					console_printf("%s; write to listenerThreadPipeFds[1] FAILED (errno= %d)\n", __FUNCTION__, errno);
+				}
+
+				console_printf("%s; before pthread_join\n", __FUNCTION__);
+				ret = pthread_join(*thread_id, NULL);
+				console_printf("%s; after pthread_join\n", __FUNCTION__);
+
+				listenerThreadPipeClose();
+
+				if (ret != 0 && ret != ESRCH)
+				{
+					console_printf("%s;pthread_join ERROR (ret= %d) ==> Abort!\n", __FUNCTION__, ret);
+					return DWPAL_FAILURE;
+				}
+
+				*thread_id = 0;
+			}
+			break;
+
+		default:
+			console_printf("%s; threadOperation (%d) not supported ==> Abort!\n", __FUNCTION__, threadOperation);
+			return DWPAL_FAILURE;
+			break;
+	}
+
+	return DWPAL_SUCCESS;
+}
+
+
+/* Stop the callback workers, once they delivered the queued events; called while the listener thread is not running */
+static void callbackWorkersStop(void)
+{
+	int i, j, ret;
+
+	for (i=0; i < numOfCallbackWorkers; i++)
+	{
+		if (callbackWorkerThreadIds[i] == 0)
+		{
+			continue;
+		}
+
+		callbackWorkers[i].shouldStop = true;
+		sem_post(&callbackWorkers[i].sem);
+
+		if ( ((ret = pthread_join(callbackWorkerThreadIds[i], NULL)) != 0) && (ret != ESRCH) )
+		{
+			console_printf("%s; pthread_join ERROR (ret= %d) ==> cont...\n", __FUNCTION__, ret);
+		}
+
+		callbackWorkerThreadIds[i] = 0;
+	}
+
+	for (i=0; i < numOfCallbackWorkers; i++)
+	{
+		eventQueueReset(&callbackWorkers[i]);
+		sem_destroy(&callbackWorkers[i].sem);
+	}
+
+	/* The events were released along with the queues */
+	pthread_rwlock_rdlock(&services_lock);
+	for (i=0; i < numOfServices; i++)
+	{
+		if (dwpalService[i] == NULL)
+		{
+			continue;
+		}
+
+		pthread_mutex_lock(&stats_mutex);
+		__atomic_store_n(&dwpalService[i]->queueBound.stats.numOfQueued, 0, __ATOMIC_RELAXED);
+		dwpalService[i]->queueBound.numOfDropsPending = 0;
+		dwpalService[i]->queueBound.numOfUndelivered = 0;
+		for (j=0; j < dwpalService[i]->queueBound.numOfOpCodeStats; j++)
+		{
+			__atomic_store_n(&dwpalService[i]->queueBound.opCodeStats[j].stats.numOfQueued, 0, __ATOMIC_RELAXED);
+		}
+		pthread_mutex_unlock(&stats_mutex);
+	}
+	pthread_rwlock_unlock(&services_lock);
+
+	free((void *)callbackWorkers);
+	callbackWorkers = NULL;
+	numOfCallbackWorkers = 0;
+}
+
+
+/* Start the configured callback workers; called before the listener thread is created. In case of a failure, the callbacks are called
+ * by the listener thread itself */
+static void callbackWorkersStart(void)
+{
+	int  i;
+	bool isFailed = false;
+
+	if (callbackWorkersConfigured == 0)
+	{
+		return;
+	}
+
+	callbackWorkers = (CallbackWorker *)calloc((size_t)callbackWorkersConfigured, sizeof(CallbackWorker));
+	if (callbackWorkers == NULL)
+	{
+		console_printf("%s; calloc (%d workers) failed ==> callbacks are called by the listener\n", __FUNCTION__, callbackWorkersConfigured);
+		return;
+	}
+
+	for (numOfCallbackWorkers=0; numOfCallbackWorkers < callbackWorkersConfigured; numOfCallbackWorkers++)
+	{
+		i = numOfCallbackWorkers;
+		eventQueueReset(&callbackWorkers[i]);
+
+		if (sem_init(&callbackWorkers[i].sem, 0 /*not shared between processes*/, 0) != 0)
+		{
+			isFailed = true;
+			break;
+		}
+
+		if (listenerThreadCreate(&callbackWorkerThreadIds[i], callbackWorkerThreadStart, &callbackWorkers[i]) != DWPAL_SUCCESS)
+		{
+			callbackWorkerThreadIds[i] = 0;
+			numOfCallbackWorkers++;  /* for its semaphore to be destroyed */
+			isFailed = true;
+			break;
+		}
+	}
+
+	if (isFailed)
+	{
+		console_printf("%s; worker %d creation failed ==> callbacks are called by the listener\n", __FUNCTION__, numOfCallbackWorkers);
+		callbackWorkersStop();
+	}
+}
+
+
+/* Keep the listener thread(s) running as long as there are interfaces; called with 'attach_mutex' locked */
+static void listenerThreadsUpdate(void)
+{
+	if (isExternalLoop)
+	{  /* the listener rounds are run by the caller's loop; have the interfaces' state handled on its next round */
+		listenerThreadWakeUp();
+		return;
+	}
+
+	if (isAnyInterfaceActive())
+	{
+		/* Create the listener thread (and the callback workers, whose events it produces), if it does NOT exist yet */
+		if (listenerThreadId == 0)
+		{
+			callbackWorkersStart();
+		}
+		threadSet(&listenerThreadId, THREAD_CREATE, listenerThreadStart);
+
+		/* The interfaces' fds are already in the listener's epoll set; wake it up, for their state to be handled right away */
+		listenerThreadWakeUp();
+	}
+	else
+	{  /* No more active interfaces ==> cancel the listener thread (the events' producer first), if it does exist */
+		threadSet(&listenerThreadId, THREAD_CANCEL, NULL);
+		callbackWorkersStop();
+	}
+}
+
+
+/* The listener thread (and the callback workers) hold 'services_lock' while calling the event callbacks; attach/detach from there
+ * would dead-lock */
+static bool isListenerThread(void)
+{
+	pthread_t self = pthread_self();
+	int       i;
+
+	if ( (dispatchThreadId != 0) && (pthread_equal(self, dispatchThreadId)) )
+	{
+		return true;
+	}
+
+	for (i=0; i < CALLBACK_WORKERS_MAX; i++)
+	{
+		if ( (callbackWorkerThreadIds[i] != 0) && (pthread_equal(self, callbackWorkerThreadIds[i])) )
+		{
+			return true;
+		}
+	}
+
+	return ( (listenerThreadId != 0) && (pthread_equal(self, listenerThreadId)) );
+}
+
+
+static DWPAL_Ret nlCmdGetCallback(char *ifname, int event, int subevent, size_t len, unsigned char *data)
+{
+	console_printf("%s Entry; ifname= '%s', event= %d, subevent= %d (len= %d)\n", __FUNCTION__, ifname, event, subevent, len);
+
+	(void)ifname;
 	(void)event;
 	(void)subevent;
 
-	if ( (len == 0) || (data == NULL) )
+	if ( (len == 0) || (data == NULL) )
+	{
+		console_printf("%s; len=0 and/or data is NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	{
+		int i;
+		size_t lenToPrint = (len <= 10)? len : 10;
+
+		console_printf("%s; Output data from the 'get' function:\n", __FUNCTION__);
+		for (i=0; i < (int)lenToPrint; i++)
+		{
+			console_printf(" 0x%x", data[i]);
+		}
+		console_printf("\n");
+	}
+
+	if (nl_response_save_data == true)
+	{
+		if (nl_response_data == NULL || nl_response_len == NULL)
+		{
+			console_printf("%s; nl_response_data or nl_response_len is NULL ==> Abort!\n", __FUNCTION__);
+			return DWPAL_FAILURE;
+		}
+
+		if (len > DRIVER_NL_TO_DWPAL_MSG_LENGTH)
+		{
+			console_printf("%s; len (%d) > (%d) ==> Abort!\n", __FUNCTION__, len, DRIVER_NL_TO_DWPAL_MSG_LENGTH);
+			return DWPAL_FAILURE;
+		}
+
+		memcpy(nl_response_data, data, len);
+		*nl_response_len = len;
+		nl_response_received = true;
+	}
+
+	return DWPAL_SUCCESS;
+}
+
+
+static DWPAL_Ret nl_cmd_socket_clean_if_needed(int idx)
+{
+	struct  timeval tv;
+	fd_set  rfds;
+	int     ret;
+
+	if (dwpal_driver_nl_fd_get(context[idx], &dwpalService[idx]->fd, &dwpalService[idx]->fdCmdGet) == DWPAL_FAILURE)
+	{
+		console_printf("%s; dwpal_driver_nl_fd_get returned error ==> Abort.\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	if (dwpalService[idx]->fdCmdGet <= 0)
+	{
+		console_printf("%s; fdCmdGet value is invalid (%d) ==> Abort!\n", __FUNCTION__, dwpalService[idx]->fdCmdGet);
+		return DWPAL_FAILURE;
+	}
+
+	do {
+		int select_failure_count = 0;
+
+		FD_ZERO(&rfds);
+		FD_SET(dwpalService[idx]->fdCmdGet, &rfds);
+
+		tv.tv_sec = 0;
+		tv.tv_usec = 0;
+
+		ret = select(dwpalService[idx]->fdCmdGet + 1, &rfds, NULL, NULL, &tv);
+		if (ret < 0)
+		{
+			console_printf("%s; select() return value= %d ==> cont...; errno= %d ('%s')\n", __FUNCTION__, ret, errno, strerror(errno));
+			select_failure_count++;
+
+			if (select_failure_count == 3)
+			{
+				console_printf("%s; select() returned error %d times in a row ==> Abort.\n", __FUNCTION__, select_failure_count);
+				return DWPAL_FAILURE;
+			}
+
+			usleep(1000);
+			continue;
+		}
+
+		if (FD_ISSET(dwpalService[idx]->fdCmdGet, &rfds))
+		{
+			console_printf("%s; nl command socket not empty ==> receive one message\n", __FUNCTION__);
+
+			nl_response_save_data = false;
+			if (dwpal_driver_nl_msg_get(context[idx], DWPAL_NL_SOLICITED_EVENT, dwpalService[idx]->nlCmdGetCallback, NULL) == DWPAL_FAILURE)
+			{
+				console_printf("%s; dwpal_driver_nl_msg_get ERROR\n", __FUNCTION__);
+				return DWPAL_FAILURE;
+			}
+		}
+
+	} while(ret);
+
+	return DWPAL_SUCCESS;
+}
+
+
+static DWPAL_Ret nl_cmd_socket_receive_response(int idx, size_t *outLen, unsigned char *outData)
+{
+	struct  timeval tv;
+	fd_set  rfds;
+	int     ret;
+
+	if (dwpal_driver_nl_fd_get(context[idx], &dwpalService[idx]->fd, &dwpalService[idx]->fdCmdGet) == DWPAL_FAILURE)
+	{
+		console_printf("%s; dwpal_driver_nl_fd_get returned error ==> Abort.\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	if (dwpalService[idx]->fdCmdGet <= 0)
+	{
+		console_printf("%s; fdCmdGet value is invalid (%d) ==> Abort!\n", __FUNCTION__, dwpalService[idx]->fdCmdGet);
+		return DWPAL_FAILURE;
+	}
+
+recv:
+	FD_ZERO(&rfds);
+	FD_SET(dwpalService[idx]->fdCmdGet, &rfds);
+
+	tv.tv_sec = 2;
+	tv.tv_usec = 0;
+
+	ret = select(dwpalService[idx]->fdCmdGet + 1, &rfds, NULL, NULL, &tv);
+	if (ret < 0)
+	{
+		console_printf("%s; select() return value= %d ==> cont...; errno= %d ('%s') ==> expected behavior when 'Interrupted system call'\n", __FUNCTION__, ret, errno, strerror(errno));
+		usleep(1000);
+		goto recv;
+	}
+
+	if (FD_ISSET(dwpalService[idx]->fdCmdGet, &rfds))
+	{
+		console_printf("%s; nl command socket not empty ==> receive one message\n", __FUNCTION__);
+
+		nl_response_save_data = true;
+		nl_response_data = outData;
+		nl_response_len = outLen;
+		nl_response_received = false;
+		if (dwpal_driver_nl_msg_get(context[idx], DWPAL_NL_SOLICITED_EVENT, dwpalService[idx]->nlCmdGetCallback, NULL) == DWPAL_FAILURE)
+		{
+			console_printf("%s; dwpal_driver_nl_msg_get ERROR\n", __FUNCTION__);
+			return DWPAL_FAILURE;
+		}
+
+		if (nl_response_received == false)
+		{
+			console_printf("%s; nlCmdGetCallback did not fill outData with a response\n", __FUNCTION__);
+			return DWPAL_FAILURE;
+		}
+	}
+
+	return DWPAL_SUCCESS;
+}
+
+
+static DWPAL_Ret nl_cmd_perform(char *ifname,
+                               unsigned int nl80211Command,
+							   CmdIdType cmdIdType,
+							   unsigned int subCommand,
+							   unsigned char *vendorData,
+							   size_t vendorDataSize,
+							   size_t *outLen,
+							   unsigned char *outData)
+{
+	int    i, idx;
+
+	console_printf("%s; ifname= '%s', nl80211Command= 0x%x, cmdIdType= %d, subCommand= 0x%x, vendorDataSize= %d, outLen= 0x%x, outData= 0x%x\n",
+	            __FUNCTION__, ifname, nl80211Command, cmdIdType, subCommand, vendorDataSize, (unsigned int)outLen, (unsigned int)outData);
+
+	for (i=0; i < (int)vendorDataSize; i++)
+	{
+		console_printf("%s; vendorData[%d]= 0x%x\n", __FUNCTION__, i, vendorData[i]);
+	}
+
+	if (interfaceIndexGet("Driver", "ALL", &idx) == DWPAL_INTERFACE_IS_DOWN)
+	{
+		console_printf("%s; interfaceIndexGet returned ERROR ==> Abort!\n", __FUNCTION__);
+		return DWPAL_INTERFACE_IS_DOWN;
+	}
+
+	console_printf("%s; interfaceIndexGet returned idx= %d\n", __FUNCTION__, idx);
+
+	if ( (outLen != NULL) && (outData != NULL) )
+	{
+		pthread_mutex_lock(&nl_cmd_mutex);
+
+		if (nl_cmd_socket_clean_if_needed(idx) == DWPAL_FAILURE)
+		{
+			console_printf("%s; nl_cmd_socket_clean_if_needed returned ERROR ==> Abort!\n", __FUNCTION__);
+			goto cmd_err;
+		}
+
+		/* Handle a command which invokes an event with the output data */
+		if (dwpal_driver_nl_cmd_send(context[idx],
+									 DWPAL_NL_SOLICITED_EVENT,
+									 ifname,
+									 nl80211Command,
+									 cmdIdType,
+									 subCommand,
+									 vendorData,
+									 vendorDataSize) == DWPAL_FAILURE)
+		{
+			console_printf("%s; dwpal_driver_nl_cmd_send returned ERROR ==> Abort!\n", __FUNCTION__);
+			goto cmd_err;
+		}
+
+		if (nl_cmd_socket_receive_response(idx, outLen, outData) == DWPAL_FAILURE)
+		{
+			console_printf("%s; nl_cmd_socket_receive_response ERROR (subCommand= 0x%x) ==> Abort!\n", __FUNCTION__, subCommand);
+			goto cmd_err;
+		}
+
+		console_printf("%s; 'get command' (subCommand= 0x%x, outLen= %d) was received\n", __FUNCTION__, subCommand, *outLen);
+		pthread_mutex_unlock(&nl_cmd_mutex);
+
+		return DWPAL_SUCCESS;
+
+cmd_err:
+	*outLen = 0;
+	pthread_mutex_unlock(&nl_cmd_mutex);
+	return DWPAL_FAILURE;
+
+	}
+	else
+	{
+		return dwpal_driver_nl_cmd_send(context[idx],
+										DWPAL_NL_UNSOLICITED_EVENT,
+										ifname,
+										nl80211Command,
+										cmdIdType,
+										subCommand,
+										vendorData,
+										vendorDataSize);
+	}
+}
+
+
+/* The Driver service is used throughout the command; keep it from being detached meanwhile */
+static DWPAL_Ret nl_cmd_handle(char *ifname,
+                               unsigned int nl80211Command,
+							   CmdIdType cmdIdType,
+							   unsigned int subCommand,
+							   unsigned char *vendorData,
+							   size_t vendorDataSize,
+							   size_t *outLen,
+							   unsigned char *outData)
+{
+	DWPAL_Ret ret;
+
+	pthread_rwlock_rdlock(&services_lock);
+	ret = nl_cmd_perform(ifname, nl80211Command, cmdIdType, subCommand, vendorData, vendorDataSize, outLen, outData);
+	pthread_rwlock_unlock(&services_lock);
+
+	return ret;
+}
+
+
+/* APIs */
+
+/*! \file dwpal_ext.c
+    \brief DWPAL library
+    
+	The purpose of this document is to describe the new dynamic configuration infrastructure, 
+	* AKA D-WPAL (Dynamic Wireless Platform Abstraction Layer).
+	In general, the main purpose of the new infrastructure is to have all dynamic configuration APIs (commands, reports, statistics, etc.),
+	in one shared library. Dynamic configuration of hostapd (via wpa_ctrl) and the Driver (via nl).
+	The library can be used by and linked with any other software clients, and will run under the caller's context, 
+	* i.e. the caller's own process/thread.
+	The role of D-WPAL is to provide:
+		Interface to / from hostapd / Driver.	
+		Parsing services.
+*/
+
+DWPAL_Ret dwpal_ext_driver_nl_scan_dump(char *ifname, DWPAL_nlNonVendorEventCallback nlEventCallback)
+{
+	int       idx;
+	DWPAL_Ret ret;
+
+	console_printf("%s; ifname= '%s'\n", __FUNCTION__, ifname);
+
+	pthread_rwlock_rdlock(&services_lock);
+
+	if (interfaceIndexGet("Driver", "ALL", &idx) == DWPAL_INTERFACE_IS_DOWN)
+	{
+		console_printf("%s; interfaceIndexGet returned ERROR ==> Abort!\n", __FUNCTION__);
+		pthread_rwlock_unlock(&services_lock);
+		return DWPAL_INTERFACE_IS_DOWN;
+	}
+
+	console_printf("%s; interfaceIndexGet returned idx= %d\n", __FUNCTION__, idx);
+
+	ret = dwpal_driver_nl_scan_dump(context[idx], ifname, nlEventCallback);
+	pthread_rwlock_unlock(&services_lock);
+
+	return ret;
+}
+
+
+DWPAL_Ret dwpal_ext_driver_nl_scan_trigger(char *ifname, ScanParams *scanParams)
+{
+	int       idx;
+	DWPAL_Ret ret;
+
+	console_printf("%s; ifname= '%s'\n", __FUNCTION__, ifname);
+
+	pthread_rwlock_rdlock(&services_lock);
+
+	if (interfaceIndexGet("Driver", "ALL", &idx) == DWPAL_INTERFACE_IS_DOWN)
+	{
+		console_printf("%s; interfaceIndexGet returned ERROR ==> Abort!\n", __FUNCTION__);
+		pthread_rwlock_unlock(&services_lock);
+		return DWPAL_INTERFACE_IS_DOWN;
+	}
+
+	console_printf("%s; interfaceIndexGet returned idx= %d\n", __FUNCTION__, idx);
+
+	ret = dwpal_driver_nl_scan_trigger(context[idx], ifname, scanParams);
+	pthread_rwlock_unlock(&services_lock);
+
+	return ret;
+}
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_driver_nl_get(char *ifname, unsigned int nl80211Command, CmdIdType cmdIdType, unsigned int subCommand, unsigned char *vendorData, size_t vendorDataSize, size_t *outLen, unsigned char *outData)
+ **************************************************************************
+ *  \brief driver-NL get command
+ *  \param[in] char *ifname - the radio interface
+ *  \param[in] unsigned int nl80211Command - NL 80211 command. Note: currently we support ONLY NL80211_CMD_VENDOR (0x67)
+ *  \param[in] CmdIdType cmdIdType - The command ID type: NETDEV, PHY or WDEV
+ *  \param[in] unsigned int subCommand - the vendor's sub-command
+ *  \param[in] unsigned char *vendorData - the vendor's data (can be NULL)
+ *  \param[in] size_t vendorDataSize - the vendor's data length (if the vendor data is NULL, it should be '0')
+ *  \param[out] size_t *outLen - The length of the returned data
+ *  \param[out] unsigned char *outData - Pointer the returned data itself
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_driver_nl_get(char *ifname, unsigned int nl80211Command, CmdIdType cmdIdType, unsigned int subCommand, unsigned char *vendorData, size_t vendorDataSize, size_t *outLen, unsigned char *outData)
+{
+	console_printf("%s; ifname= '%s', nl80211Command= 0x%x, cmdIdType= %d, subCommand= 0x%x\n", __FUNCTION__, ifname, nl80211Command, cmdIdType, subCommand);
+
+	return nl_cmd_handle(ifname, nl80211Command, cmdIdType, subCommand, vendorData, vendorDataSize, outLen, outData);
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_driver_nl_cmd_send(char *ifname, unsigned int nl80211Command, CmdIdType cmdIdType, unsigned int subCommand, unsigned char *vendorData, size_t vendorDataSize)
+ **************************************************************************
+ *  \brief driver-NL send command
+ *  \param[in] char *ifname - the radio interface
+ *  \param[in] unsigned int nl80211Command - NL 80211 command. Note: currently we support ONLY NL80211_CMD_VENDOR (0x67)
+ *  \param[in] CmdIdType cmdIdType - The command ID type: NETDEV, PHY or WDEV
+ *  \param[in] unsigned int subCommand - the vendor's sub-command
+ *  \param[in] unsigned char *vendorData - the vendor's data (can be NULL)
+ *  \param[in] size_t vendorDataSize - the vendor's data length (if the vendor data is NULL, it should be '0')
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_driver_nl_cmd_send(char *ifname, unsigned int nl80211Command, CmdIdType cmdIdType, unsigned int subCommand, unsigned char *vendorData, size_t vendorDataSize)
+{
+	if ( (ifname == NULL) || ((vendorDataSize > 0) && (vendorData == NULL)) )
+	{
+		console_printf("%s; ifname or vendorData is NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	console_printf("%s; ifname= '%s', nl80211Command= 0x%x, cmdIdType= %d, subCommand= 0x%x, vendorDataSize= %d\n", __FUNCTION__, ifname, nl80211Command, cmdIdType, subCommand, vendorDataSize);
+
+	return nl_cmd_handle(ifname, nl80211Command, cmdIdType, subCommand, vendorData, vendorDataSize, NULL, NULL);
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_driver_nl_detach(void)
+ **************************************************************************
+ *  \brief Resets/clear the Driver-NL interface
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_driver_nl_detach(void)
+{
+	int       idx;
+	void      *localContext;
+	DWPAL_Ret ret;
+
+	console_printf("%s Entry\n", __FUNCTION__);
+
+	if (isListenerThread())
+	{
+		console_printf("%s; called from an event callback ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	pthread_mutex_lock(&attach_mutex);
+
+	if ((ret = interfaceIndexGet("Driver", "ALL", &idx)) == DWPAL_INTERFACE_IS_DOWN)
+	{
+		console_printf("%s; interfaceIndexGet returned ERROR ==> Abort!\n", __FUNCTION__);
+		goto end;
+	}
+
+	console_printf("%s; interfaceIndexGet returned idx= %d\n", __FUNCTION__, idx);
+
+	/* Take the interface out of the running listener thread, and then dealocate it */
+	pthread_rwlock_wrlock(&services_lock);
+	if (dwpalService[idx] != NULL)
+	{
+		listenerFdRemove(idx);
+		interfaceIndexRemove(idx);
+	}
+	localContext = context[idx];
+	context[idx] = NULL;
+	pthread_rwlock_unlock(&services_lock);
+
+	if (dwpal_driver_nl_detach(&localContext) == DWPAL_FAILURE)
+	{
+		console_printf("%s; dwpal_driver_nl_detach returned ERROR ==> Abort!\n", __FUNCTION__);
+		ret = DWPAL_FAILURE;
+		goto end;
+	}
+
+	ret = DWPAL_SUCCESS;
+end:
+	listenerThreadsUpdate();
+
+	pthread_mutex_unlock(&attach_mutex);
+	return ret;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_driver_nl_attach(DwpalExtNlEventCallback nlEventCallback)
+ **************************************************************************
+ *  \brief Driver-NL interface attach and event callback register
+ *  \param[in] DwpalExtNlEventCallback nlEventCallback - The callback function to be called while event will be received via this interface
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_driver_nl_attach(DwpalExtNlEventCallback nlEventCallback, DwpalExtNlNonVendorEventCallback nlNonVendorEventCallback)
+{
+	int       idx;
+	void      *localContext = NULL;
+	DWPAL_Ret ret;
+
+	console_printf("%s Entry\n", __FUNCTION__);
+
+	if (isListenerThread())
+	{
+		console_printf("%s; called from an event callback ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	pthread_mutex_lock(&attach_mutex);
+
+	pthread_rwlock_wrlock(&services_lock);
+	ret = interfaceIndexCreate("Driver", "ALL", &idx);
+	pthread_rwlock_unlock(&services_lock);
+	if (ret == DWPAL_FAILURE)
+	{
+		console_printf("%s; interfaceIndexCreate returned ERROR ==> Abort!\n", __FUNCTION__);
+		pthread_mutex_unlock(&attach_mutex);
+		return ret;
+	}
+	else if (ret == DWPAL_INTERFACE_ALREADY_UP)
+	{
+		console_printf("%s; Interface (idx= %d) is already up ==> cont...\n", __FUNCTION__, idx);
+		pthread_mutex_unlock(&attach_mutex);
+		return DWPAL_SUCCESS;
+	}
+
+	console_printf("%s; interfaceIndexCreate successfully; returned idx= %d\n", __FUNCTION__, idx);
+
+	/* The interface is set up aside, and only then added into the running listener thread */
+	ret = DWPAL_SUCCESS;
+	if (dwpal_driver_nl_attach(&localContext /*OUT*/) == DWPAL_FAILURE)
+	{
+		console_printf("%s; dwpal_driver_nl_attach returned ERROR ==> Abort!\n", __FUNCTION__);
+		ret = DWPAL_FAILURE;
+	}
+
+	pthread_rwlock_wrlock(&services_lock);
+	if (ret == DWPAL_FAILURE)
+	{
+		interfaceIndexRemove(idx);
+	}
+	else
+	{
+		/* nlEventCallback can be NULL */
+		dwpalService[idx]->nlEventCallback = nlEventCallback;
+
+		/* Register here the internal static callback function of the 'get command' event */
+		dwpalService[idx]->nlCmdGetCallback = nlCmdGetCallback;
+
+		/* Register here the internal static callback function of the 'non-Vendor' event */
+		dwpalService[idx]->nlNonVendorEventCallback = nlNonVendorEventCallback;
+
+		context[idx] = localContext;
+		listenerFdAdd(idx);
+	}
+	pthread_rwlock_unlock(&services_lock);
+
+	listenerThreadsUpdate();
+
+	pthread_mutex_unlock(&attach_mutex);
+	return ret;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_hostap_cmd_timeout_set(unsigned int timeoutMs)
+ **************************************************************************
+ *  \brief Set the default deadline of the hostap commands sent via dwpal_ext_hostap_cmd_send
+ *  \param[in] unsigned int timeoutMs - The deadline (in msec) of a command round trip; 0 restores DWPAL_HOSTAPD_CMD_TIMEOUT_MS
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_hostap_cmd_timeout_set(unsigned int timeoutMs)
+{
+	console_printf("%s; timeoutMs= %u\n", __FUNCTION__, timeoutMs);
+
+	hostapCmdTimeoutMs = timeoutMs;
+
+	return DWPAL_SUCCESS;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_hostap_cmd_send(char *VAPName, char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char *reply , size_t *replyLen)
+ **************************************************************************
+ *  \brief Build and send hostap command
+ *  \param[in] char *VAPName - The interface's radio/VAP name to send the command to
+ *  \param[in] char *cmdHeader - The beginning of the hostap command string
+ *  \param[in] FieldsToCmdParse *fieldsToCmdParse - The command parsing information, in which accordingly, the command string (after the header) will be created
+ *  \param[out] char *reply - The output string returning from the hostap command
+ *  \param[in,out] size_t *replyLen - Provide the max output string length, and get back the actual string length
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, DWPAL_TIMEOUT if no reply within the deadline, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_hostap_cmd_send(char *VAPName, char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char *reply /*OUT*/, size_t *replyLen /*IN/OUT*/)
+{
+	return dwpal_ext_hostap_cmd_send_timeout(VAPName, cmdHeader, fieldsToCmdParse, reply, replyLen, 0 /*use the default deadline*/);
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_hostap_cmd_send_timeout(char *VAPName, char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char *reply , size_t *replyLen, unsigned int timeoutMs)
+ **************************************************************************
+ *  \brief Build and send hostap command, bounding the round trip by a deadline
+ *  \param[in] char *VAPName - The interface's radio/VAP name to send the command to
+ *  \param[in] char *cmdHeader - The beginning of the hostap command string
+ *  \param[in] FieldsToCmdParse *fieldsToCmdParse - The command parsing information, in which accordingly, the command string (after the header) will be created
+ *  \param[out] char *reply - The output string returning from the hostap command
+ *  \param[in,out] size_t *replyLen - Provide the max output string length, and get back the actual string length
+ *  \param[in] unsigned int timeoutMs - The deadline (in msec) of this command; 0 uses the default (see dwpal_ext_hostap_cmd_timeout_set)
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, DWPAL_TIMEOUT if no reply within the deadline, other for failure)
+ *  \note The deadline does not include the time waiting for other threads' commands on the same interface
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_hostap_cmd_send_timeout(char *VAPName, char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char *reply /*OUT*/, size_t *replyLen /*IN/OUT*/, unsigned int timeoutMs)
+{
+	int          idx;
+	unsigned int ttlMs = 0;
+	DWPAL_Ret    ret;
+
+	if ( (VAPName == NULL) || (cmdHeader == NULL) || (reply == NULL) || (replyLen == NULL) )
+	{
+		console_printf("%s; input params error ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	console_printf("%s; VAPName= '%s', cmdHeader= '%s'\n", __FUNCTION__, VAPName, cmdHeader);
+
+	pthread_rwlock_rdlock(&services_lock);
+	ret = interfaceIndexGet("hostap", VAPName, &idx);
+	pthread_rwlock_unlock(&services_lock);
+
+	if (ret == DWPAL_INTERFACE_IS_DOWN)
+	{
+		console_printf("%s; interfaceIndexGet (VAPName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
+		*replyLen = 0;
+		return DWPAL_INTERFACE_IS_DOWN;
+	}
+
+	console_printf("%s; interfaceIndexGet returned idx= %d\n", __FUNCTION__, idx);
+
+	/* Only complete command strings (no fields to parse) are cacheable */
+	if (fieldsToCmdParse == NULL)
+	{
+		pthread_mutex_lock(&cache_mutex);
+		ttlMs = cmdCacheTtlGet(cmdHeader);
+		pthread_mutex_unlock(&cache_mutex);
+	}
+
+	if (timeoutMs == 0)
+	{
+		timeoutMs = hostapCmdTimeoutMs;
+	}
+
+	if (ttlMs > 0)
+	{
+		ret = hostapCmdSendCached(idx, VAPName, cmdHeader, ttlMs, reply, replyLen, timeoutMs);
+	}
+	else
+	{
+		ret = hostapCmdSend(idx, VAPName, cmdHeader, fieldsToCmdParse, &reply, replyLen, false /*isReplyAlloc*/, timeoutMs);
+	}
+
+	if (ret != DWPAL_SUCCESS)
+	{
+		return ret;
+	}
+
+	if (strncmp(cmdHeader, "PING", sizeof("PING")))
+	{
+		cli_printf("%s; replyLen= %d\nreply=\n%s\n", __FUNCTION__, (int)*replyLen, reply);
+	}
+	else
+	{
+		console_printf("%s; replyLen= %d\nreply=\n%s\n", __FUNCTION__, (int)*replyLen, reply);
+	}
+
+	return DWPAL_SUCCESS;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_hostap_cmd_send_alloc(char *VAPName, char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char **reply, size_t *replyLen)
+ **************************************************************************
+ *  \brief Build and send hostap command, and receive the complete reply, whatever its size is (i.e. long multi-line reports)
+ *  \param[in] char *VAPName - The interface's radio/VAP name to send the command to
+ *  \param[in] char *cmdHeader - The beginning of the hostap command string
+ *  \param[in] FieldsToCmdParse *fieldsToCmdParse - The command parsing information, in which accordingly, the command string (after the header) will be created
+ *  \param[out] char **reply - The output string returning from the hostap command; allocated to its size, and should be freed by the caller
+ *  \param[out] size_t *replyLen - The actual string length
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, DWPAL_TIMEOUT if no reply within the deadline, other for failure)
+ *  \note The replies of this API are never served from, nor stored in, the reply cache
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_hostap_cmd_send_alloc(char *VAPName, char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char **reply /*OUT*/, size_t *replyLen /*OUT*/)
+{
+	int       idx;
+	DWPAL_Ret ret;
+
+	if ( (VAPName == NULL) || (cmdHeader == NULL) || (reply == NULL) || (replyLen == NULL) )
+	{
+		console_printf("%s; input params error ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	*reply = NULL;
+	*replyLen = 0;
+
+	console_printf("%s; VAPName= '%s', cmdHeader= '%s'\n", __FUNCTION__, VAPName, cmdHeader);
+
+	pthread_rwlock_rdlock(&services_lock);
+	ret = interfaceIndexGet("hostap", VAPName, &idx);
+	pthread_rwlock_unlock(&services_lock);
+
+	if (ret == DWPAL_INTERFACE_IS_DOWN)
+	{
+		console_printf("%s; interfaceIndexGet (VAPName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
+		return DWPAL_INTERFACE_IS_DOWN;
+	}
+
+	if ((ret = hostapCmdSend(idx, VAPName, cmdHeader, fieldsToCmdParse, reply, replyLen, true /*isReplyAlloc*/, hostapCmdTimeoutMs)) != DWPAL_SUCCESS)
+	{
+		return ret;
+	}
+
+	cli_printf("%s; replyLen= %d\nreply=\n%s\n", __FUNCTION__, (int)*replyLen, *reply);
+
+	return DWPAL_SUCCESS;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_hostap_cmd_cache_set(char *cmdName, unsigned int ttlMs)
+ **************************************************************************
+ *  \brief Enable/disable the reply cache of an idempotent hostap command (i.e. GET_RADIO_INFO)
+ *  \param[in] char *cmdName - The command name (first word of the command string) to cache the replies of
+ *  \param[in] unsigned int ttlMs - The time (in msec) a reply is valid for; 0 disables caching of this command
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ *  \note Replies are cached per (VAP, full command string); commands with fields to parse are never cached
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_hostap_cmd_cache_set(char *cmdName, unsigned int ttlMs)
+{
+	int i;
+
+	if ( (cmdName == NULL) || (cmdName[0] == '\0') || (strcspn(cmdName, " ") != strnlen_s(cmdName, DWPAL_OPCODE_STRING_LENGTH)) )
+	{
+		console_printf("%s; input params error ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	console_printf("%s; cmdName= '%s', ttlMs= %u\n", __FUNCTION__, cmdName, ttlMs);
+
+	pthread_mutex_lock(&cache_mutex);
+
+	for (i=0; i < numOfCmdCachePolicies; i++)
+	{
+		if (!strncmp(cmdCachePolicy[i].cmdName, cmdName, sizeof(cmdCachePolicy[i].cmdName)))
+		{
+			break;
+		}
+	}
+
+	if (ttlMs == 0)
+	{
+		if (i < numOfCmdCachePolicies)
+		{
+			numOfCmdCachePolicies--;
+			cmdCachePolicy[i] = cmdCachePolicy[numOfCmdCachePolicies];
+		}
+	}
+	else
+	{
+		if (i == numOfCmdCachePolicies)
+		{
+			if (numOfCmdCachePolicies == NUM_OF_CACHED_COMMANDS)
+			{
+				pthread_mutex_unlock(&cache_mutex);
+				console_printf("%s; no room for cmdName= '%s' ==> Abort!\n", __FUNCTION__, cmdName);
+				return DWPAL_FAILURE;
+			}
+
+			strncpy_s(cmdCachePolicy[i].cmdName, sizeof(cmdCachePolicy[i].cmdName), cmdName, sizeof(cmdCachePolicy[i].cmdName) - 1);
+			numOfCmdCachePolicies++;
+		}
+
+		cmdCachePolicy[i].ttlMs = ttlMs;
+	}
+
+	/* New TTL applies to new replies only; drop what is already cached */
+	cmdCacheEntriesRemove(NULL, false /*isExpiredOnly*/);
+
+	pthread_mutex_unlock(&cache_mutex);
+
+	return DWPAL_SUCCESS;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_hostap_cmd_cache_flush(char *VAPName)
+ **************************************************************************
+ *  \brief Invalidate the cached hostap replies, i.e. after a configuration change
+ *  \param[in] char *VAPName - The interface's radio/VAP name to flush the replies of; NULL flushes all interfaces
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_hostap_cmd_cache_flush(char *VAPName)
+{
+	console_printf("%s; VAPName= '%s'\n", __FUNCTION__, (VAPName == NULL) ? "ALL" : VAPName);
+
+	pthread_mutex_lock(&cache_mutex);
+	cmdCacheEntriesRemove(VAPName, false /*isExpiredOnly*/);
+	pthread_mutex_unlock(&cache_mutex);
+
+	return DWPAL_SUCCESS;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_hostap_two_way_set(bool isTwoWay)
+ **************************************************************************
+ *  \brief Select the connection mode of the hostap interfaces to be attached
+ *  \param[in] bool isTwoWay - true: a single socket per interface, for both commands and events;
+ *                              false (default): one-way, a command socket and an event socket per interface
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ *  \note Already attached interfaces keep their mode (recoveries included) till they are detached
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_hostap_two_way_set(bool isTwoWay)
+{
+	console_printf("%s; isTwoWay= %d\n", __FUNCTION__, isTwoWay);
+
+	pthread_mutex_lock(&attach_mutex);
+	isHostapTwoWay = isTwoWay;
+	pthread_mutex_unlock(&attach_mutex);
+
+	return DWPAL_SUCCESS;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_hostap_event_subscribe(char *VAPName, char *opCodes[], size_t numOfOpCodes, int minLevel)
+ **************************************************************************
+ *  \brief Set the events to be delivered to the callback of an attached interface; the rest are dropped by the listener thread
+ *         before they are received into a buffer. Optionally, set the minimal level of the events hostapd sends, so that lower level
+ *         events do not cross the socket at all (hostapd's LEVEL; an old hostapd ignores it, and the events are filtered here only)
+ *  \param[in] char *VAPName - The interface's radio/VAP name
+ *  \param[in] char *opCodes[] - The op-codes of the events to be delivered (i.e. "AP-STA-CONNECTED"); NULL to deliver all the events
+ *  \param[in] size_t numOfOpCodes - The number of entries in opCodes
+ *  \param[in] int minLevel - The minimal level of the events hostapd sends (i.e. 3 for MSG_INFO); 0 for hostapd's default
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ *  \note The subscription is kept over recoveries, and is reset by the interface detach; the library's own notifications
+ *        (i.e. "INTERFACE_RECONNECTED_OK") are always delivered
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_hostap_event_subscribe(char *VAPName, char *opCodes[], size_t numOfOpCodes, int minLevel)
+{
+	int       idx;
+	size_t    i;
+	char      (*subscribedOpCodes)[DWPAL_OPCODE_STRING_LENGTH] = NULL;
+	DWPAL_Ret ret = DWPAL_SUCCESS;
+
+	if (VAPName == NULL)
+	{
+		console_printf("%s; VAPName is NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	console_printf("%s Entry; VAPName= '%s', numOfOpCodes= %d, minLevel= %d\n", __FUNCTION__, VAPName, (opCodes == NULL) ? 0 : (int)numOfOpCodes, minLevel);
+
+	if (isListenerThread())
+	{
+		console_printf("%s; called from an event callback (VAPName= '%s') ==> Abort!\n", __FUNCTION__, VAPName);
+		return DWPAL_FAILURE;
+	}
+
+	if (opCodes != NULL)
+	{
+		/* Even an empty subscription is allocated; NULL stands for "all events" */
+		subscribedOpCodes = malloc((numOfOpCodes + 1) * DWPAL_OPCODE_STRING_LENGTH);
+		if (subscribedOpCodes == NULL)
+		{
+			console_printf("%s; malloc failed ==> Abort!\n", __FUNCTION__);
+			return DWPAL_FAILURE;
+		}
+
+		for (i=0; i < numOfOpCodes; i++)
+		{
+			if (opCodes[i] == NULL)
+			{
+				console_printf("%s; opCodes[%d] is NULL ==> Abort!\n", __FUNCTION__, (int)i);
+				free((void *)subscribedOpCodes);
+				return DWPAL_FAILURE;
+			}
+
+			strncpy_s(subscribedOpCodes[i], DWPAL_OPCODE_STRING_LENGTH, opCodes[i], DWPAL_OPCODE_STRING_LENGTH - 1);
+		}
+	}
+
+	pthread_rwlock_wrlock(&services_lock);
+
+	if (interfaceIndexGet("hostap", VAPName, &idx) != DWPAL_SUCCESS)
+	{
+		console_printf("%s; interfaceIndexGet (VAPName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
+		ret = DWPAL_FAILURE;
+	}
+	else
+	{
+		/* Swap the subscriptions; the old one is freed below */
+		char (*oldOpCodes)[DWPAL_OPCODE_STRING_LENGTH] = dwpalService[idx]->subscribedOpCodes;
+
+		dwpalService[idx]->subscribedOpCodes = subscribedOpCodes;
+		dwpalService[idx]->numOfSubscribedOpCodes = (opCodes == NULL) ? 0 : numOfOpCodes;
+		subscribedOpCodes = oldOpCodes;
+
+		if (minLevel != dwpalService[idx]->eventLevel)
+		{
+			dwpalService[idx]->eventLevel = minLevel;
+
+			/* Otherwise, it is pushed down once the interface is connected */
+			pthread_mutex_lock(&context_mutex);
+			if ( (context[idx] != NULL) && (!dwpalService[idx]->isConnectionEstablishNeeded) )
+			{
+				hostapEventLevelApply(idx);
+			}
+			pthread_mutex_unlock(&context_mutex);
+		}
+	}
+
+	pthread_rwlock_unlock(&services_lock);
+
+	free((void *)subscribedOpCodes);
+
+	return ret;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_hostap_event_rcvbuf_set(int size)
+ **************************************************************************
+ *  \brief Set the receive buffer size (SO_RCVBUF) of the hostap event sockets, attached ones and the ones to be attached (recoveries included)
+ *  \param[in] int size - The receive buffer size, in bytes; 0 keeps the system default for the sockets to be attached
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ *  \note The number of events a socket queues is limited by net.unix.max_dgram_qlen as well; overflows are detected (see
+ *        dwpal_ext_hostap_event_stats_get), and the callback is notified via "EVENTS_RESYNC_NEEDED" to re-query the interface state
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_hostap_event_rcvbuf_set(int size)
+{
+	int i;
+
+	if (size < 0)
 	{
-		console_printf("%s; len=0 and/or data is NULL ==> Abort!\n", __FUNCTION__);
+		console_printf("%s; size (%d) is not valid ==> Abort!\n", __FUNCTION__, size);
 		return DWPAL_FAILURE;
 	}
 
+	console_printf("%s; size= %d\n", __FUNCTION__, size);
+
+	if (isListenerThread())
 	{
-		int i;
-		size_t lenToPrint = (len <= 10)? len : 10;
+		console_printf("%s; called from an event callback ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
 
-		console_printf("%s; Output data from the 'get' function:\n", __FUNCTION__);
-		for (i=0; i < (int)lenToPrint; i++)
+	pthread_mutex_lock(&attach_mutex);
+	pthread_rwlock_wrlock(&services_lock);
+
+	hostapEventRcvBufSize = size;
+
+	if (size > 0)
+	{
+		pthread_mutex_lock(&context_mutex);
+		for (i=0; i < numOfServices; i++)
 		{
-			console_printf(" 0x%x", data[i]);
+			if ( (dwpalService[i] != NULL) && (context[i] != NULL) && (!strncmp(dwpalService[i]->interfaceType, "hostap", 7)) )
+			{
+				dwpal_hostap_event_rcvbuf_set(context[i], size);
+			}
 		}
-		console_printf("\n");
+		pthread_mutex_unlock(&context_mutex);
 	}
 
-	if (nl_response_save_data == true)
+	pthread_rwlock_unlock(&services_lock);
+	pthread_mutex_unlock(&attach_mutex);
+
+	return DWPAL_SUCCESS;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_hostap_event_stats_get(char *VAPName, DwpalExtHostapEventStats *stats)
+ **************************************************************************
+ *  \brief Get the event loss counters of an attached interface
+ *  \param[in] char *VAPName - The interface's radio/VAP name
+ *  \param[out] DwpalExtHostapEventStats *stats - The counters, since the interface was attached
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_hostap_event_stats_get(char *VAPName, DwpalExtHostapEventStats *stats /*OUT*/)
+{
+	int       idx;
+	DWPAL_Ret ret = DWPAL_SUCCESS;
+
+	if ( (VAPName == NULL) || (stats == NULL) )
 	{
-		if (nl_response_data == NULL || nl_response_len == NULL)
+		console_printf("%s; VAPName/stats is NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	pthread_rwlock_rdlock(&services_lock);
+
+	if (interfaceIndexGet("hostap", VAPName, &idx) != DWPAL_SUCCESS)
+	{
+		console_printf("%s; interfaceIndexGet (VAPName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
+		ret = DWPAL_FAILURE;
+	}
+	else
+	{
+		pthread_mutex_lock(&stats_mutex);
+		*stats = dwpalService[idx]->eventStats;
+		pthread_mutex_unlock(&stats_mutex);
+	}
+
+	pthread_rwlock_unlock(&services_lock);
+
+	return ret;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_hostap_state_track_set(char *VAPName, bool isEnabled)
+ **************************************************************************
+ *  \brief Enable/disable the state tracking of an attached interface. The library keeps its last known state (the station list, kept
+ *         up to date by the station events, and the radio info); after a reconnection (or an events resync), it takes a new snapshot
+ *         of the state (over the listener rounds, a few commands at a time), and delivers the diff against the last known one via
+ *         "INTERFACE_STATE_DIFF", with the diff as the message:
+ *         lines of "STA_ADDED <MAC>", "STA_REMOVED <MAC>" and "RADIO_INFO <name>=<value>" (of the changed radio info fields)
+ *  \param[in] char *VAPName - The interface's radio/VAP name
+ *  \param[in] bool isEnabled - true: the first snapshot is taken by the listener thread (no diff is delivered for it); false: stop tracking
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ *  \note "AP-STA-CONNECTED"/"AP-STA-DISCONNECTED" are received (but not delivered) even if not subscribed to
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_hostap_state_track_set(char *VAPName, bool isEnabled)
+{
+	int         idx;
+	HostapState *state = NULL;
+	DWPAL_Ret   ret = DWPAL_SUCCESS;
+
+	if (VAPName == NULL)
+	{
+		console_printf("%s; VAPName is NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	console_printf("%s; VAPName= '%s', isEnabled= %d\n", __FUNCTION__, VAPName, isEnabled);
+
+	if (isListenerThread())
+	{
+		console_printf("%s; called from an event callback (VAPName= '%s') ==> Abort!\n", __FUNCTION__, VAPName);
+		return DWPAL_FAILURE;
+	}
+
+	if (isEnabled)
+	{
+		if ((state = (HostapState *)calloc(1, sizeof(HostapState))) == NULL)
 		{
-			console_printf("%s; nl_response_data or nl_response_len is NULL ==> Abort!\n", __FUNCTION__);
+			console_printf("%s; calloc failed ==> Abort!\n", __FUNCTION__);
 			return DWPAL_FAILURE;
 		}
+		state->isBaselineNeeded = true;
+	}
 
-		if (len > DRIVER_NL_TO_DWPAL_MSG_LENGTH)
+	pthread_rwlock_wrlock(&services_lock);
+
+	if (interfaceIndexGet("hostap", VAPName, &idx) != DWPAL_SUCCESS)
+	{
+		console_printf("%s; interfaceIndexGet (VAPName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
+		ret = DWPAL_FAILURE;
+	}
+	else if ( (isEnabled) && (dwpalService[idx]->state != NULL) )
+	{  /* already tracked; keep its state */
+		hostapStateFree(state);
+		state = NULL;
+	}
+	else
+	{
+		HostapState *oldState = dwpalService[idx]->state;
+
+		dwpalService[idx]->state = state;
+		state = oldState;
+	}
+
+	pthread_rwlock_unlock(&services_lock);
+
+	hostapStateFree(state);
+
+	if ( (ret == DWPAL_SUCCESS) && (isEnabled) )
+	{  /* for the baseline snapshot */
+		listenerThreadWakeUp();
+	}
+
+	return ret;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_hostap_interface_detach(char *VAPName)
+ **************************************************************************
+ *  \brief Will reset and detach the interface towards/from the hostapd/supplicant of the requested radio/VAP interface
+ *  \param[in] char *VAPName - The interface's radio/VAP name to detach from
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_hostap_interface_detach(char *VAPName)
+{
+	int       idx;
+	void      *localContext;
+	DWPAL_Ret ret;
+
+	if (VAPName == NULL)
+	{
+		console_printf("%s; VAPName is NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	console_printf("%s Entry; VAPName= '%s'\n", __FUNCTION__, VAPName);
+
+	if (isListenerThread())
+	{
+		console_printf("%s; called from an event callback (VAPName= '%s') ==> Abort!\n", __FUNCTION__, VAPName);
+		return DWPAL_FAILURE;
+	}
+
+	pthread_mutex_lock(&attach_mutex);
+
+	if ((ret = interfaceIndexGet("hostap", VAPName, &idx)) == DWPAL_INTERFACE_IS_DOWN)
+	{
+		console_printf("%s; interfaceIndexGet (VAPName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
+		goto end;
+	}
+
+	console_printf("%s; interfaceIndexGet returned idx= %d\n", __FUNCTION__, idx);
+
+	/* Take the interface out of the running listener thread, and of the command senders, and then dealocate it */
+	pthread_rwlock_wrlock(&services_lock);
+	pthread_mutex_lock(&context_mutex);
+	if (dwpalService[idx] != NULL)
+	{
+		listenerFdRemove(idx);
+		interfaceIndexRemove(idx);
+	}
+	localContext = context[idx];
+	context[idx] = NULL;
+	pthread_mutex_unlock(&context_mutex);
+	pthread_rwlock_unlock(&services_lock);
+
+	pthread_mutex_lock(&cache_mutex);
+	cmdCacheEntriesRemove(VAPName, false /*isExpiredOnly*/);
+	pthread_mutex_unlock(&cache_mutex);
+
+	if (localContext != NULL && dwpal_hostap_interface_detach(&localContext) == DWPAL_FAILURE)
+	{
+		console_printf("%s; dwpal_hostap_interface_detach (VAPName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
+		ret = DWPAL_FAILURE;
+		goto end;
+	}
+
+	ret = DWPAL_SUCCESS;
+end:
+	listenerThreadsUpdate();
+
+	pthread_mutex_unlock(&attach_mutex);
+	return ret;
+}
+
+
+/* Attach an interface into the running listener thread; called with 'attach_mutex' locked */
+static DWPAL_Ret hostapInterfaceAttach(char *VAPName, DwpalExtHostapEventCallback hostapEventCallback)
+{
+	int       idx;
+	void      *localContext = NULL;
+	DWPAL_Ret ret;
+
+	pthread_rwlock_wrlock(&services_lock);
+	ret = interfaceIndexCreate("hostap", VAPName, &idx);
+	pthread_rwlock_unlock(&services_lock);
+	if (ret == DWPAL_FAILURE)
+	{
+		console_printf("%s; interfaceIndexCreate (VAPName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
+		return ret;
+	}
+	else if (ret == DWPAL_INTERFACE_ALREADY_UP)
+	{
+		console_printf("%s; Interface (idx= %d) is already up ==> cont...\n", __FUNCTION__, idx);
+		return DWPAL_SUCCESS;
+	}
+
+	console_printf("%s; interfaceIndexCreate successfully; returned idx= %d\n", __FUNCTION__, idx);
+
+	/* The interface is set up aside, and only then added into the running listener thread */
+	ret = dwpal_hostap_interface_attach(&localContext /*OUT*/, VAPName,
+	                                    dwpalService[idx]->isTwoWay ? hostapTwoWayEventCallback : NULL /*use one-way interface*/);
+	if (ret != DWPAL_SUCCESS)
+	{
+		console_printf("%s; dwpal_hostap_interface_attach (VAPName= '%s') returned ERROR ==> try later on...\n", __FUNCTION__, VAPName);
+
+		/* in this case, continue and try to establish the connection later on */
+		ret = DWPAL_INTERFACE_IS_DOWN;
+	}
+	else if (hostapEventRcvBufSize > 0)
+	{
+		dwpal_hostap_event_rcvbuf_set(localContext, hostapEventRcvBufSize);
+	}
+
+	pthread_rwlock_wrlock(&services_lock);
+
+	/* Set the callback whether attach succeeded or not */
+	dwpalService[idx]->hostapEventCallback = hostapEventCallback;
+
+	pthread_mutex_lock(&context_mutex);
+	if (context[idx] != NULL)
+	{  /* the listener thread's recovery got there first */
+		ret = DWPAL_SUCCESS;
+	}
+	else
+	{
+		context[idx] = localContext;
+		localContext = NULL;
+		dwpalService[idx]->isConnectionEstablishNeeded = (ret != DWPAL_SUCCESS);
+		if (context[idx] != NULL)
 		{
-			console_printf("%s; len (%d) > (%d) ==> Abort!\n", __FUNCTION__, len, DRIVER_NL_TO_DWPAL_MSG_LENGTH);
-			return DWPAL_FAILURE;
+			listenerFdAdd(idx);
 		}
+	}
+	pthread_mutex_unlock(&context_mutex);
 
-		memcpy(nl_response_data, data, len);
-		*nl_response_len = len;
-		nl_response_received = true;
+	pthread_rwlock_unlock(&services_lock);
+
+	if (localContext != NULL)
+	{
+		dwpal_hostap_interface_detach(&localContext);
 	}
 
-	return DWPAL_SUCCESS;
+	return ret;
 }
 
 
-static DWPAL_Ret nl_cmd_socket_clean_if_needed(int idx)
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_hostap_interface_attach(char *VAPName, DwpalExtHostapEventCallback hostapEventCallback)
+ **************************************************************************
+ *  \brief Hostapd/supplicant interface attach and event callback register
+ *  \param[in] char *VAPName - The interface's radio/vap name to set attachment to
+ *  \param[in] DwpalExtHostapEventCallback hostapEventCallback - The callback function to be called when an event will be received via this interface
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_hostap_interface_attach(char *VAPName, DwpalExtHostapEventCallback hostapEventCallback)
+{
+	DWPAL_Ret ret;
+
+	if (VAPName == NULL)
+	{
+		console_printf("%s; VAPName is NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	if (hostapEventCallback == NULL)
+	{
+		console_printf("%s; hostapEventCallback is NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
+
+	console_printf("%s Entry; VAPName= '%s'\n", __FUNCTION__, VAPName);
+
+	if (isListenerThread())
+	{
+		console_printf("%s; called from an event callback (VAPName= '%s') ==> Abort!\n", __FUNCTION__, VAPName);
+		return DWPAL_FAILURE;
+	}
+
+	pthread_mutex_lock(&attach_mutex);
+
+	ret = hostapInterfaceAttach(VAPName, hostapEventCallback);
+
+	listenerThreadsUpdate();
+
+	pthread_mutex_unlock(&attach_mutex);
+	return ret;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_hostap_interfaces_attach(char *VAPNames[], size_t numOfVAPs, DwpalExtHostapEventCallback hostapEventCallback)
+ **************************************************************************
+ *  \brief Hostapd/supplicant interfaces attach and event callback register, all at once (i.e. at boot)
+ *  \param[in] char *VAPNames[] - The interfaces' radio/vap names to set attachment to
+ *  \param[in] size_t numOfVAPs - The number of entries in VAPNames
+ *  \param[in] DwpalExtHostapEventCallback hostapEventCallback - The callback function to be called when an event will be received via these interfaces
+ *  \return DWPAL_Ret (DWPAL_SUCCESS if all are attached, DWPAL_INTERFACE_IS_DOWN if some are not up yet (they will be connected
+ *          later on, as with dwpal_ext_hostap_interface_attach), other for failure of one or more of the interfaces)
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_hostap_interfaces_attach(char *VAPNames[], size_t numOfVAPs, DwpalExtHostapEventCallback hostapEventCallback)
 {
-	struct  timeval tv;
-	fd_set  rfds;
-	int     ret;
+	size_t    i;
+	DWPAL_Ret ret, totalRet = DWPAL_SUCCESS;
 
-	if (dwpal_driver_nl_fd_get(context[idx], &dwpalService[idx]->fd, &dwpalService[idx]->fdCmdGet) == DWPAL_FAILURE)
+	if ( (VAPNames == NULL) || (hostapEventCallback == NULL) )
 	{
-		console_printf("%s; dwpal_driver_nl_fd_get returned error ==> Abort.\n", __FUNCTION__);
+		console_printf("%s; VAPNames/hostapEventCallback is NULL ==> Abort!\n", __FUNCTION__);
 		return DWPAL_FAILURE;
 	}
 
-	if (dwpalService[idx]->fdCmdGet <= 0)
+	console_printf("%s Entry; numOfVAPs= %d\n", __FUNCTION__, (int)numOfVAPs);
+
+	if (isListenerThread())
 	{
-		console_printf("%s; fdCmdGet value is invalid (%d) ==> Abort!\n", __FUNCTION__, dwpalService[idx]->fdCmdGet);
+		console_printf("%s; called from an event callback ==> Abort!\n", __FUNCTION__);
 		return DWPAL_FAILURE;
 	}
 
-	do {
-		int select_failure_count = 0;
-
-		FD_ZERO(&rfds);
-		FD_SET(dwpalService[idx]->fdCmdGet, &rfds);
-
-		tv.tv_sec = 0;
-		tv.tv_usec = 0;
+	pthread_mutex_lock(&attach_mutex);
 
-		ret = select(dwpalService[idx]->fdCmdGet + 1, &rfds, NULL, NULL, &tv);
-		if (ret < 0)
+	for (i=0; i < numOfVAPs; i++)
+	{
+		if (VAPNames[i] == NULL)
 		{
-			console_printf("%s; select() return value= %d ==> cont...; errno= %d ('%s')\n", __FUNCTION__, ret, errno, strerror(errno));
-			select_failure_count++;
-
-			if (select_failure_count == 3)
-			{
-				console_printf("%s; select() returned error %d times in a row ==> Abort.\n", __FUNCTION__, select_failure_count);
-				return DWPAL_FAILURE;
-			}
-
-			usleep(1000);
+			console_printf("%s; VAPNames[%d] is NULL ==> cont...\n", __FUNCTION__, (int)i);
+			totalRet = DWPAL_FAILURE;
 			continue;
 		}
 
-		if (FD_ISSET(dwpalService[idx]->fdCmdGet, &rfds))
+		ret = hostapInterfaceAttach(VAPNames[i], hostapEventCallback);
+		if (ret == DWPAL_FAILURE)
 		{
-			console_printf("%s; nl command socket not empty ==> receive one message\n", __FUNCTION__);
-
-			nl_response_save_data = false;
-			if (dwpal_driver_nl_msg_get(context[idx], DWPAL_NL_SOLICITED_EVENT, dwpalService[idx]->nlCmdGetCallback, NULL) == DWPAL_FAILURE)
-			{
-				console_printf("%s; dwpal_driver_nl_msg_get ERROR\n", __FUNCTION__);
-				return DWPAL_FAILURE;
-			}
+			totalRet = DWPAL_FAILURE;
 		}
+		else if ( (ret == DWPAL_INTERFACE_IS_DOWN) && (totalRet == DWPAL_SUCCESS) )
+		{
+			totalRet = DWPAL_INTERFACE_IS_DOWN;
+		}
+	}
 
-	} while(ret);
+	/* The listener thread is started (or woken up) once for all the interfaces */
+	listenerThreadsUpdate();
 
-	return DWPAL_SUCCESS;
+	pthread_mutex_unlock(&attach_mutex);
+	return totalRet;
 }
 
 
-static DWPAL_Ret nl_cmd_socket_receive_response(int idx, size_t *outLen, unsigned char *outData)
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_callback_workers_set(int numOfWorkers)
+ **************************************************************************
+ *  \brief Set the number of worker threads calling the event callbacks (hostapd and driver), so that a slow callback does not stall
+ *         the events' intake. The events of a VAP (or of a driver interface) are all delivered, in order, by the same worker.
+ *         A running listener thread is restarted with the new workers.
+ *  \param[in] int numOfWorkers - The number of workers (up to CALLBACK_WORKERS_MAX); 0 for calling the callbacks by the listener
+ *             thread itself (the default, unless built with EVENT_CALLBACK_THREAD)
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_callback_workers_set(int numOfWorkers)
 {
-	struct  timeval tv;
-	fd_set  rfds;
-	int     ret;
+	console_printf("%s; numOfWorkers= %d\n", __FUNCTION__, numOfWorkers);
 
-	if (dwpal_driver_nl_fd_get(context[idx], &dwpalService[idx]->fd, &dwpalService[idx]->fdCmdGet) == DWPAL_FAILURE)
+	if ( (numOfWorkers < 0) || (numOfWorkers > CALLBACK_WORKERS_MAX) )
 	{
-		console_printf("%s; dwpal_driver_nl_fd_get returned error ==> Abort.\n", __FUNCTION__);
+		console_printf("%s; numOfWorkers (%d) out of range (0 <-> %d) ==> Abort!\n", __FUNCTION__, numOfWorkers, CALLBACK_WORKERS_MAX);
 		return DWPAL_FAILURE;
 	}
 
-	if (dwpalService[idx]->fdCmdGet <= 0)
+	if (isListenerThread())
 	{
-		console_printf("%s; fdCmdGet value is invalid (%d) ==> Abort!\n", __FUNCTION__, dwpalService[idx]->fdCmdGet);
+		console_printf("%s; called from an event callback ==> Abort!\n", __FUNCTION__);
 		return DWPAL_FAILURE;
 	}
 
-recv:
-	FD_ZERO(&rfds);
-	FD_SET(dwpalService[idx]->fdCmdGet, &rfds);
+	pthread_mutex_lock(&attach_mutex);
 
-	tv.tv_sec = 2;
-	tv.tv_usec = 0;
+	callbackWorkersConfigured = numOfWorkers;
 
-	ret = select(dwpalService[idx]->fdCmdGet + 1, &rfds, NULL, NULL, &tv);
-	if (ret < 0)
-	{
-		console_printf("%s; select() return value= %d ==> cont...; errno= %d ('%s') ==> expected behavior when 'Interrupted system call'\n", __FUNCTION__, ret, errno, strerror(errno));
-		usleep(1000);
-		goto recv;
+	if (isExternalLoop)
+	{  /* no listener round (the workers' producer) runs meanwhile */
+		pthread_mutex_lock(&dispatch_mutex);
+		callbackWorkersStop();
+		callbackWorkersStart();
+		pthread_mutex_unlock(&dispatch_mutex);
 	}
-
-	if (FD_ISSET(dwpalService[idx]->fdCmdGet, &rfds))
+	else if ( (listenerThreadId != 0) && (numOfCallbackWorkers != numOfWorkers) )
 	{
-		console_printf("%s; nl command socket not empty ==> receive one message\n", __FUNCTION__);
-
-		nl_response_save_data = true;
-		nl_response_data = outData;
-		nl_response_len = outLen;
-		nl_response_received = false;
-		if (dwpal_driver_nl_msg_get(context[idx], DWPAL_NL_SOLICITED_EVENT, dwpalService[idx]->nlCmdGetCallback, NULL) == DWPAL_FAILURE)
-		{
-			console_printf("%s; dwpal_driver_nl_msg_get ERROR\n", __FUNCTION__);
-			return DWPAL_FAILURE;
-		}
-
-		if (nl_response_received == false)
-		{
-			console_printf("%s; nlCmdGetCallback did not fill outData with a response\n", __FUNCTION__);
-			return DWPAL_FAILURE;
-		}
+		/* The listener thread (the workers' producer) is stopped first, and both are re-created with the new configuration */
+		threadSet(&listenerThreadId, THREAD_CANCEL, NULL);
+		callbackWorkersStop();
+		listenerThreadsUpdate();
 	}
 
+	pthread_mutex_unlock(&attach_mutex);
 	return DWPAL_SUCCESS;
 }
 
 
-static DWPAL_Ret nl_cmd_handle(char *ifname,
-                               unsigned int nl80211Command,
-							   CmdIdType cmdIdType,
-							   unsigned int subCommand,
-							   unsigned char *vendorData,
-							   size_t vendorDataSize,
-							   size_t *outLen,
-							   unsigned char *outData)
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_external_loop_set(bool isEnabled)
+ **************************************************************************
+ *  \brief Set whether the events are handled by the caller's event loop, instead of by a listener thread. In that mode, no listener
+ *         thread is created; the caller polls the fd of dwpal_ext_fd_get, and calls dwpal_ext_dispatch once it is readable (and at
+ *         least once a second, for the PING checks and the recovery). The callbacks are called by the thread calling
+ *         dwpal_ext_dispatch (unless dwpal_ext_callback_workers_set is used as well)
+ *  \param[in] bool isEnabled - true for the caller's event loop, false for a listener thread (the default)
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_external_loop_set(bool isEnabled)
 {
-	int    i, idx;
+	DWPAL_Ret ret = DWPAL_SUCCESS;
 
-	console_printf("%s; ifname= '%s', nl80211Command= 0x%x, cmdIdType= %d, subCommand= 0x%x, vendorDataSize= %d, outLen= 0x%x, outData= 0x%x\n",
-	            __FUNCTION__, ifname, nl80211Command, cmdIdType, subCommand, vendorDataSize, (unsigned int)outLen, (unsigned int)outData);
+	console_printf("%s; isEnabled= %d\n", __FUNCTION__, isEnabled);
 
-	for (i=0; i < (int)vendorDataSize; i++)
+	if (isListenerThread())
 	{
-		console_printf("%s; vendorData[%d]= 0x%x\n", __FUNCTION__, i, vendorData[i]);
+		console_printf("%s; called from an event callback ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
 	}
 
-	if (interfaceIndexGet("Driver", "ALL", &idx) == DWPAL_INTERFACE_IS_DOWN)
+	pthread_mutex_lock(&attach_mutex);
+
+	if (isEnabled == isExternalLoop)
 	{
-		console_printf("%s; interfaceIndexGet returned ERROR ==> Abort!\n", __FUNCTION__);
-		return DWPAL_INTERFACE_IS_DOWN;
+		pthread_mutex_unlock(&attach_mutex);
+		return DWPAL_SUCCESS;
 	}
 
-	console_printf("%s; interfaceIndexGet returned idx= %d\n", __FUNCTION__, idx);
-
-	if ( (outLen != NULL) && (outData != NULL) )
+	if (isEnabled)
 	{
-		pthread_mutex_lock(&nl_cmd_mutex);
+		/* The listener thread's work is handed over to the caller's loop */
+		threadSet(&listenerThreadId, THREAD_CANCEL, NULL);
+		callbackWorkersStop();
 
-		if (nl_cmd_socket_clean_if_needed(idx) == DWPAL_FAILURE)
+		pthread_mutex_lock(&dispatch_mutex);
+		listenerThreadShouldStop = 0;
+		if (listenerThreadPipeOpen() != DWPAL_SUCCESS)
 		{
-			console_printf("%s; nl_cmd_socket_clean_if_needed returned ERROR ==> Abort!\n", __FUNCTION__);
-			goto cmd_err;
+			ret = DWPAL_FAILURE;
 		}
-
-		/* Handle a command which invokes an event with the output data */
-		if (dwpal_driver_nl_cmd_send(context[idx],
-									 DWPAL_NL_SOLICITED_EVENT,
-									 ifname,
-									 nl80211Command,
-									 cmdIdType,
-									 subCommand,
-									 vendorData,
-									 vendorDataSize) == DWPAL_FAILURE)
+		else if (listenerSetUp() != DWPAL_SUCCESS)
 		{
-			console_printf("%s; dwpal_driver_nl_cmd_send returned ERROR ==> Abort!\n", __FUNCTION__);
-			goto cmd_err;
+			listenerThreadPipeClose();
+			ret = DWPAL_FAILURE;
 		}
-
-		if (nl_cmd_socket_receive_response(idx, outLen, outData) == DWPAL_FAILURE)
+		else
 		{
-			console_printf("%s; nl_cmd_socket_receive_response ERROR (subCommand= 0x%x) ==> Abort!\n", __FUNCTION__, subCommand);
-			goto cmd_err;
+			callbackWorkersStart();
+			isExternalLoop = true;
 		}
-
-		console_printf("%s; 'get command' (subCommand= 0x%x, outLen= %d) was received\n", __FUNCTION__, subCommand, *outLen);
-		pthread_mutex_unlock(&nl_cmd_mutex);
-
-		return DWPAL_SUCCESS;
-
-cmd_err:
-	*outLen = 0;
-	pthread_mutex_unlock(&nl_cmd_mutex);
-	return DWPAL_FAILURE;
-
+		pthread_mutex_unlock(&dispatch_mutex);
 	}
 	else
 	{
-		return dwpal_driver_nl_cmd_send(context[idx],
-										DWPAL_NL_UNSOLICITED_EVENT,
-										ifname,
-										nl80211Command,
-										cmdIdType,
-										subCommand,
-										vendorData,
-										vendorDataSize);
+		pthread_mutex_lock(&dispatch_mutex);
+		isExternalLoop = false;
+		listenerTearDown();
+		callbackWorkersStop();
+		listenerThreadPipeClose();
+		pthread_mutex_unlock(&dispatch_mutex);
 	}
-}
 
+	/* In case of a failure, the listener thread goes on */
+	listenerThreadsUpdate();
 
-/* APIs */
+	pthread_mutex_unlock(&attach_mutex);
+	return ret;
+}
 
-/*! \file dwpal_ext.c
-    \brief DWPAL library
-    
-	The purpose of this document is to describe the new dynamic configuration infrastructure, 
-	* AKA D-WPAL (Dynamic Wireless Platform Abstraction Layer).
-	In general, the main purpose of the new infrastructure is to have all dynamic configuration APIs (commands, reports, statistics, etc.),
-	in one shared library. Dynamic configuration of hostapd (via wpa_ctrl) and the Driver (via nl).
-	The library can be used by and linked with any other software clients, and will run under the caller's context, 
-	* i.e. the caller's own process/thread.
-	The role of D-WPAL is to provide:
-		Interface to / from hostapd / Driver.	
-		Parsing services.
-*/
 
-DWPAL_Ret dwpal_ext_driver_nl_scan_dump(char *ifname, DWPAL_nlNonVendorEventCallback nlEventCallback)
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_fd_get(int *fd)
+ **************************************************************************
+ *  \brief Get the fd to poll (for reading) in the caller's event loop; see dwpal_ext_external_loop_set
+ *  \param[out] int *fd - A single fd, that is readable whenever any of the interfaces has pending events
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_fd_get(int *fd /*OUT*/)
 {
-	int idx;
-
-	console_printf("%s; ifname= '%s'\n", __FUNCTION__, ifname);
-
-	if (interfaceIndexGet("Driver", "ALL", &idx) == DWPAL_INTERFACE_IS_DOWN)
+	if (fd == NULL)
 	{
-		console_printf("%s; interfaceIndexGet returned ERROR ==> Abort!\n", __FUNCTION__);
-		return DWPAL_INTERFACE_IS_DOWN;
+		console_printf("%s; fd is NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
 	}
 
-	console_printf("%s; interfaceIndexGet returned idx= %d\n", __FUNCTION__, idx);
-
-	return dwpal_driver_nl_scan_dump(context[idx], ifname, nlEventCallback);
-}
-
-
-DWPAL_Ret dwpal_ext_driver_nl_scan_trigger(char *ifname, ScanParams *scanParams)
-{
-	int idx;
-
-	console_printf("%s; ifname= '%s'\n", __FUNCTION__, ifname);
-
-	if (interfaceIndexGet("Driver", "ALL", &idx) == DWPAL_INTERFACE_IS_DOWN)
+	if ( (!isExternalLoop) || (listenerEpollFd < 0) )
 	{
-		console_printf("%s; interfaceIndexGet returned ERROR ==> Abort!\n", __FUNCTION__);
-		return DWPAL_INTERFACE_IS_DOWN;
+		console_printf("%s; the external loop is not set ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
 	}
 
-	console_printf("%s; interfaceIndexGet returned idx= %d\n", __FUNCTION__, idx);
+	*fd = listenerEpollFd;
 
-	return dwpal_driver_nl_scan_trigger(context[idx], ifname, scanParams);
+	return DWPAL_SUCCESS;
 }
 
+
 /**************************************************************************/
-/*! \fn DWPAL_Ret dwpal_ext_driver_nl_get(char *ifname, unsigned int nl80211Command, CmdIdType cmdIdType, unsigned int subCommand, unsigned char *vendorData, size_t vendorDataSize, size_t *outLen, unsigned char *outData)
+/*! \fn DWPAL_Ret dwpal_ext_dispatch(int timeoutMs)
  **************************************************************************
- *  \brief driver-NL get command
- *  \param[in] char *ifname - the radio interface
- *  \param[in] unsigned int nl80211Command - NL 80211 command. Note: currently we support ONLY NL80211_CMD_VENDOR (0x67)
- *  \param[in] CmdIdType cmdIdType - The command ID type: NETDEV, PHY or WDEV
- *  \param[in] unsigned int subCommand - the vendor's sub-command
- *  \param[in] unsigned char *vendorData - the vendor's data (can be NULL)
- *  \param[in] size_t vendorDataSize - the vendor's data length (if the vendor data is NULL, it should be '0')
- *  \param[out] size_t *outLen - The length of the returned data
- *  \param[out] unsigned char *outData - Pointer the returned data itself
+ *  \brief Handle the pending events (calling their callbacks), and the due PING checks and recovery, in the caller's event loop;
+ *         see dwpal_ext_external_loop_set
+ *  \param[in] int timeoutMs - The time to wait for events in case that there are none; 0 for not waiting, (-1) for no limit
  *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
  ***************************************************************************/
-DWPAL_Ret dwpal_ext_driver_nl_get(char *ifname, unsigned int nl80211Command, CmdIdType cmdIdType, unsigned int subCommand, unsigned char *vendorData, size_t vendorDataSize, size_t *outLen, unsigned char *outData)
+DWPAL_Ret dwpal_ext_dispatch(int timeoutMs)
 {
-	console_printf("%s; ifname= '%s', nl80211Command= 0x%x, cmdIdType= %d, subCommand= 0x%x\n", __FUNCTION__, ifname, nl80211Command, cmdIdType, subCommand);
-
-	return nl_cmd_handle(ifname, nl80211Command, cmdIdType, subCommand, vendorData, vendorDataSize, outLen, outData);
-}
+	if (isListenerThread())
+	{
+		console_printf("%s; called from an event callback ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
+	}
 
+	pthread_mutex_lock(&dispatch_mutex);
 
-/**************************************************************************/
-/*! \fn DWPAL_Ret dwpal_ext_driver_nl_cmd_send(char *ifname, unsigned int nl80211Command, CmdIdType cmdIdType, unsigned int subCommand, unsigned char *vendorData, size_t vendorDataSize)
- **************************************************************************
- *  \brief driver-NL send command
- *  \param[in] char *ifname - the radio interface
- *  \param[in] unsigned int nl80211Command - NL 80211 command. Note: currently we support ONLY NL80211_CMD_VENDOR (0x67)
- *  \param[in] CmdIdType cmdIdType - The command ID type: NETDEV, PHY or WDEV
- *  \param[in] unsigned int subCommand - the vendor's sub-command
- *  \param[in] unsigned char *vendorData - the vendor's data (can be NULL)
- *  \param[in] size_t vendorDataSize - the vendor's data length (if the vendor data is NULL, it should be '0')
- *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
- ***************************************************************************/
-DWPAL_Ret dwpal_ext_driver_nl_cmd_send(char *ifname, unsigned int nl80211Command, CmdIdType cmdIdType, unsigned int subCommand, unsigned char *vendorData, size_t vendorDataSize)
-{
-	if ( (ifname == NULL) || ((vendorDataSize > 0) && (vendorData == NULL)) )
+	if (!isExternalLoop)
 	{
-		console_printf("%s; ifname or vendorData is NULL ==> Abort!\n", __FUNCTION__);
+		pthread_mutex_unlock(&dispatch_mutex);
+		console_printf("%s; the external loop is not set ==> Abort!\n", __FUNCTION__);
 		return DWPAL_FAILURE;
 	}
 
-	console_printf("%s; ifname= '%s', nl80211Command= 0x%x, cmdIdType= %d, subCommand= 0x%x, vendorDataSize= %d\n", __FUNCTION__, ifname, nl80211Command, cmdIdType, subCommand, vendorDataSize);
+	/* The callbacks called from here are rejected from attaching/detaching, as if called by the listener thread */
+	dispatchThreadId = pthread_self();
+	listenerRoundRun(timeoutMs);
+	dispatchThreadId = 0;
 
-	return nl_cmd_handle(ifname, nl80211Command, cmdIdType, subCommand, vendorData, vendorDataSize, NULL, NULL);
+	pthread_mutex_unlock(&dispatch_mutex);
+	return DWPAL_SUCCESS;
 }
 
 
 /**************************************************************************/
-/*! \fn DWPAL_Ret dwpal_ext_driver_nl_detach(void)
+/*! \fn DWPAL_Ret dwpal_ext_hostap_event_coalesce_set(char *opCode, unsigned int windowMs, unsigned int maxPerSec)
  **************************************************************************
- *  \brief Resets/clear the Driver-NL interface
+ *  \brief Absorb bursts of an event (i.e. "UNCONNECTED-STA-RSSI", "RRM-BEACON-REP-RECEIVED") inside the library, for all the hostap
+ *         interfaces: coalesce it, so that only the latest event per (VAP, op-code, MAC) within a window is delivered, once the window
+ *         passed; and/or rate limit it, so that at most maxPerSec events per (VAP, op-code) are delivered in a second.
+ *         The events that are not delivered are counted (see dwpal_ext_hostap_event_suppressed_get)
+ *  \param[in] char *opCode - The op-code of the event (i.e. "AP-CSA-FINISHED")
+ *  \param[in] unsigned int windowMs - The coalescing window, starting at the first event of a (VAP, op-code, MAC); 0 for no coalescing
+ *  \param[in] unsigned int maxPerSec - The maximal number of events delivered per second (the coalesced ones included); 0 for no limit
  *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ *  \note The MAC is the token that follows the VAP name, in case that it is a MAC address; the events without it are coalesced per
+ *        (VAP, op-code). Both windowMs and maxPerSec being 0 stops coalescing the op-code; the events that are held are still delivered.
+ *        In case of dwpal_ext_external_loop_set, the held events are delivered by dwpal_ext_dispatch
  ***************************************************************************/
-DWPAL_Ret dwpal_ext_driver_nl_detach(void)
+DWPAL_Ret dwpal_ext_hostap_event_coalesce_set(char *opCode, unsigned int windowMs, unsigned int maxPerSec)
 {
-	int idx;
-	DWPAL_Ret ret;
-
-	console_printf("%s Entry\n", __FUNCTION__);
-
-	pthread_mutex_lock(&attach_mutex);
+	int i;
 
-	if ((ret = interfaceIndexGet("Driver", "ALL", &idx)) == DWPAL_INTERFACE_IS_DOWN)
+	if ( (opCode == NULL) || (opCode[0] == '\0') || (strcspn(opCode, " ") != strnlen_s(opCode, DWPAL_OPCODE_STRING_LENGTH)) )
 	{
-		console_printf("%s; interfaceIndexGet returned ERROR ==> Abort!\n", __FUNCTION__);
-		goto end;
+		console_printf("%s; input params error ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
 	}
 
-	console_printf("%s; interfaceIndexGet returned idx= %d\n", __FUNCTION__, idx);
-
-	/* Cancel the listener thread, if it does exist */
-#if defined EVENT_CALLBACK_THREAD
-	threadSet(&eventHandlerThreadId, THREAD_CANCEL, NULL);
-#endif
-	threadSet(&listenerThreadId, THREAD_CANCEL, NULL);
+	console_printf("%s; opCode= '%s', windowMs= %u, maxPerSec= %u\n", __FUNCTION__, opCode, windowMs, maxPerSec);
 
-	/* dealocate the interface (after canceling the listener thread) */
-	if (dwpalService[idx] != NULL)
+	if (isListenerThread())
 	{
-		free((void *)dwpalService[idx]);
-		dwpalService[idx] = NULL;
+		console_printf("%s; called from an event callback (opCode= '%s') ==> Abort!\n", __FUNCTION__, opCode);
+		return DWPAL_FAILURE;
 	}
 
-	if (dwpal_driver_nl_detach(&context[idx]) == DWPAL_FAILURE)
+	pthread_rwlock_wrlock(&services_lock);
+
+	for (i=0; i < numOfEventCoalescePolicies; i++)
 	{
-		console_printf("%s; dwpal_driver_nl_detach returned ERROR ==> Abort!\n", __FUNCTION__);
-		ret = DWPAL_FAILURE;
-		goto end;
+		if (!strncmp(eventCoalescePolicy[i].opCode, opCode, sizeof(eventCoalescePolicy[i].opCode)))
+		{
+			break;
+		}
 	}
 
-	ret = DWPAL_SUCCESS;
-end:
-	if (isAnyInterfaceActive())
-	{ /* There are still active interfaces */
-		/* Create the listener thread, if it does NOT exist yet */
-#if defined EVENT_CALLBACK_THREAD
-		threadSet(&eventHandlerThreadId, THREAD_CREATE, eventHandlerThreadStart);
-#endif
-		threadSet(&listenerThreadId, THREAD_CREATE, listenerThreadStart);
-	}
-#if defined EVENT_CALLBACK_THREAD
-	else if (dwpal_event_handler != (-1))
+	if (i == numOfEventCoalescePolicies)
 	{
-		pid_t pid = getpid();
-		char  socketName[SOCKET_NAME_LENGTH] = "\0";
-
-		snprintf_s(socketName, sizeof(socketName), "%s_%d", EVENT_HANDLER_SOCKET, pid);
+		if ( (windowMs == 0) && (maxPerSec == 0) )
+		{
+			pthread_rwlock_unlock(&services_lock);
+			return DWPAL_SUCCESS;
+		}
 
-		if (close(dwpal_event_handler) == (-1))
+		if (numOfEventCoalescePolicies == NUM_OF_COALESCED_OPCODES)
 		{
-			console_printf("%s; close() fail; dwpal_event_handler= %d; errno= %d ('%s')\n", __FUNCTION__, dwpal_event_handler, errno, strerror(errno));
+			pthread_rwlock_unlock(&services_lock);
+			console_printf("%s; no room for opCode= '%s' ==> Abort!\n", __FUNCTION__, opCode);
+			return DWPAL_FAILURE;
 		}
 
-		unlink(socketName);
-		dwpal_event_handler = (-1);
+		strncpy_s(eventCoalescePolicy[i].opCode, sizeof(eventCoalescePolicy[i].opCode), opCode, sizeof(eventCoalescePolicy[i].opCode) - 1);
+		numOfEventCoalescePolicies++;
 	}
-#endif
 
-	pthread_mutex_unlock(&attach_mutex);
-	return ret;
+	eventCoalescePolicy[i].windowMs = windowMs;
+	eventCoalescePolicy[i].maxPerSec = maxPerSec;
+
+	pthread_rwlock_unlock(&services_lock);
+
+	return DWPAL_SUCCESS;
 }
 
 
 /**************************************************************************/
-/*! \fn DWPAL_Ret dwpal_ext_driver_nl_attach(DwpalExtNlEventCallback nlEventCallback)
+/*! \fn DWPAL_Ret dwpal_ext_hostap_event_suppressed_get(char *VAPName, char *opCode, unsigned int *numOfSuppressed)
  **************************************************************************
- *  \brief Driver-NL interface attach and event callback register
- *  \param[in] DwpalExtNlEventCallback nlEventCallback - The callback function to be called while event will be received via this interface
+ *  \brief Get the number of events of an op-code that were not delivered to the callback of an attached interface, due to its coalescing
+ *         or rate limiting (see dwpal_ext_hostap_event_coalesce_set)
+ *  \param[in] char *VAPName - The interface's radio/VAP name
+ *  \param[in] char *opCode - The op-code of the event
+ *  \param[out] unsigned int *numOfSuppressed - The number of suppressed events, since the interface was attached
  *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ *  \note The total over all op-codes is numOfSuppressedEvents of dwpal_ext_hostap_event_stats_get
  ***************************************************************************/
-DWPAL_Ret dwpal_ext_driver_nl_attach(DwpalExtNlEventCallback nlEventCallback, DwpalExtNlNonVendorEventCallback nlNonVendorEventCallback)
+DWPAL_Ret dwpal_ext_hostap_event_suppressed_get(char *VAPName, char *opCode, unsigned int *numOfSuppressed /*OUT*/)
 {
-	int       idx;
-	DWPAL_Ret ret;
-
-	console_printf("%s Entry\n", __FUNCTION__);
+	int       idx, i;
+	DWPAL_Ret ret = DWPAL_SUCCESS;
 
-	pthread_mutex_lock(&attach_mutex);
-
-	ret = interfaceIndexCreate("Driver", "ALL", &idx);
-	if (ret == DWPAL_FAILURE)
-	{
-		console_printf("%s; interfaceIndexCreate returned ERROR ==> Abort!\n", __FUNCTION__);
-		goto end;
-	}
-	else if (ret == DWPAL_INTERFACE_ALREADY_UP)
+	if ( (VAPName == NULL) || (opCode == NULL) || (numOfSuppressed == NULL) )
 	{
-		console_printf("%s; Interface (idx= %d) is already up ==> cont...\n", __FUNCTION__, idx);
-		ret = DWPAL_SUCCESS;
-		goto end;
+		console_printf("%s; VAPName/opCode/numOfSuppressed is NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
 	}
 
-	console_printf("%s; interfaceIndexCreate successfully; returned idx= %d\n", __FUNCTION__, idx);
+	*numOfSuppressed = 0;
 
-	/* Cancel the listener thread, if it does exist */
-#if defined EVENT_CALLBACK_THREAD
-	threadSet(&eventHandlerThreadId, THREAD_CANCEL, NULL);
-#endif
-	threadSet(&listenerThreadId, THREAD_CANCEL, NULL);
+	pthread_rwlock_rdlock(&services_lock);
 
-	if (dwpal_driver_nl_attach(&context[idx] /*OUT*/) == DWPAL_FAILURE)
+	if (interfaceIndexGet("hostap", VAPName, &idx) != DWPAL_SUCCESS)
 	{
-		console_printf("%s; dwpal_driver_nl_attach returned ERROR ==> Abort!\n", __FUNCTION__);
+		console_printf("%s; interfaceIndexGet (VAPName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
 		ret = DWPAL_FAILURE;
-		goto end;
 	}
-
-	/* nlEventCallback can be NULL */
-	dwpalService[idx]->nlEventCallback = nlEventCallback;
-
-	/* Register here the internal static callback function of the 'get command' event */
-	dwpalService[idx]->nlCmdGetCallback = nlCmdGetCallback;
-
-	/* Register here the internal static callback function of the 'non-Vendor' event */
-	dwpalService[idx]->nlNonVendorEventCallback = nlNonVendorEventCallback;
-
-	ret = DWPAL_SUCCESS;
-end:
-	if (ret == DWPAL_FAILURE && dwpalService[idx] != NULL)
+	else
 	{
-		free((void *)dwpalService[idx]);
-		dwpalService[idx] = NULL;
+		for (i=0; i < numOfEventCoalescePolicies; i++)
+		{
+			if (!strncmp(eventCoalescePolicy[i].opCode, opCode, sizeof(eventCoalescePolicy[i].opCode)))
+			{
+				pthread_mutex_lock(&stats_mutex);
+				*numOfSuppressed = dwpalService[idx]->coalesce.numOfSuppressed[i];
+				pthread_mutex_unlock(&stats_mutex);
+				break;
+			}
+		}
 	}
 
-	/* Create the listener thread, if it does NOT exist yet */
-	if (isAnyInterfaceActive())
-	{
-#if defined EVENT_CALLBACK_THREAD
-		threadSet(&eventHandlerThreadId, THREAD_CREATE, eventHandlerThreadStart);
-#endif
-		threadSet(&listenerThreadId, THREAD_CREATE, listenerThreadStart);
-	}
+	pthread_rwlock_unlock(&services_lock);
 
-	pthread_mutex_unlock(&attach_mutex);
 	return ret;
 }
 
 
 /**************************************************************************/
-/*! \fn DWPAL_Ret dwpal_ext_hostap_cmd_send(char *VAPName, char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char *reply , size_t *replyLen)
+/*! \fn DWPAL_Ret dwpal_ext_hostap_event_priority_set(char *opCode, bool isHighPriority)
  **************************************************************************
- *  \brief Build and send hostap command
- *  \param[in] char *VAPName - The interface's radio/VAP name to send the command to
- *  \param[in] char *cmdHeader - The beginning of the hostap command string
- *  \param[in] FieldsToCmdParse *fieldsToCmdParse - The command parsing information, in which accordingly, the command string (after the header) will be created
- *  \param[out] char *reply - The output string returning from the hostap command
- *  \param[in,out] size_t *replyLen - Provide the max output string length, and get back the actual string length
+ *  \brief Set whether a hostap event is latency-critical; in case of callback workers (see dwpal_ext_callback_workers_set), the
+ *         latency-critical events are queued to a separate queue, that is delivered ahead of the rest of the events.
+ *         By default, "DFS-RADAR-DETECTED" and "AP-CSA-FINISHED" are latency-critical
+ *  \param[in] char *opCode - The op-code of the event
+ *  \param[in] bool isHighPriority - true: latency-critical; false: delivered along with the rest of the events
  *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ *  \note The events of an interface are delivered in order within each priority only; a latency-critical station event ("AP-STA-*")
+ *        is delivered ahead only in case that none of its interface's events is queued, for the station's state not to be inverted
  ***************************************************************************/
-DWPAL_Ret dwpal_ext_hostap_cmd_send(char *VAPName, char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char *reply /*OUT*/, size_t *replyLen /*IN/OUT*/)
+DWPAL_Ret dwpal_ext_hostap_event_priority_set(char *opCode, bool isHighPriority)
 {
-	int idx;
+	int i;
 
-	if ( (VAPName == NULL) || (cmdHeader == NULL) || (reply == NULL) || (replyLen == NULL) )
+	if ( (opCode == NULL) || (opCode[0] == '\0') || (strcspn(opCode, " ") != strnlen_s(opCode, DWPAL_OPCODE_STRING_LENGTH)) )
 	{
 		console_printf("%s; input params error ==> Abort!\n", __FUNCTION__);
 		return DWPAL_FAILURE;
 	}
 
-	console_printf("%s; VAPName= '%s', cmdHeader= '%s'\n", __FUNCTION__, VAPName, cmdHeader);
+	console_printf("%s; opCode= '%s', isHighPriority= %d\n", __FUNCTION__, opCode, isHighPriority);
 
-	if (interfaceIndexGet("hostap", VAPName, &idx) == DWPAL_INTERFACE_IS_DOWN)
+	if (isListenerThread())
 	{
-		console_printf("%s; interfaceIndexGet (VAPName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
-		*replyLen = 0;
-		return DWPAL_INTERFACE_IS_DOWN;
+		console_printf("%s; called from an event callback (opCode= '%s') ==> Abort!\n", __FUNCTION__, opCode);
+		return DWPAL_FAILURE;
 	}
 
-	console_printf("%s; interfaceIndexGet returned idx= %d\n", __FUNCTION__, idx);
+	pthread_rwlock_wrlock(&services_lock);
 
-	pthread_mutex_lock(&context_mutex);
-	if (dwpalService[idx]->isConnectionEstablishNeeded == true)
+	for (i=0; i < numOfHighPriorityOpCodes; i++)
 	{
-		console_printf("%s; interface is being reconnected, but still NOT ready ==> Abort!\n", __FUNCTION__);
-		*replyLen = 0;
-		pthread_mutex_unlock(&context_mutex);
-		return DWPAL_INTERFACE_IS_DOWN;
+		if (!strncmp(highPriorityOpCodes[i], opCode, DWPAL_OPCODE_STRING_LENGTH))
+		{
+			break;
+		}
 	}
 
-	if (context[idx] == NULL)
+	if (!isHighPriority)
 	{
-		console_printf("%s; context[%d] is NULL ==> Abort!\n", __FUNCTION__, idx);
-		*replyLen = 0;
-		pthread_mutex_unlock(&context_mutex);
+		if (i < numOfHighPriorityOpCodes)
+		{
+			numOfHighPriorityOpCodes--;
+			memcpy(highPriorityOpCodes[i], highPriorityOpCodes[numOfHighPriorityOpCodes], DWPAL_OPCODE_STRING_LENGTH);
+		}
+	}
+	else if (i == numOfHighPriorityOpCodes)
+	{
+		if (numOfHighPriorityOpCodes == NUM_OF_HIGH_PRIORITY_OPCODES)
+		{
+			pthread_rwlock_unlock(&services_lock);
+			console_printf("%s; no room for opCode= '%s' ==> Abort!\n", __FUNCTION__, opCode);
+			return DWPAL_FAILURE;
+		}
+
+		strncpy_s(highPriorityOpCodes[i], DWPAL_OPCODE_STRING_LENGTH, opCode, DWPAL_OPCODE_STRING_LENGTH - 1);
+		numOfHighPriorityOpCodes++;
+	}
+
+	pthread_rwlock_unlock(&services_lock);
+
+	return DWPAL_SUCCESS;
+}
+
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_driver_nl_event_priority_set(int subevent, bool isHighPriority)
+ **************************************************************************
+ *  \brief Set whether a driver vendor event is latency-critical, the same as dwpal_ext_hostap_event_priority_set does for the hostap
+ *         events. By default, LTQ_NL80211_VENDOR_EVENT_RADAR_DETECTED and LTQ_NL80211_VENDOR_EVENT_CSA_RECEIVED are latency-critical
+ *  \param[in] int subevent - The vendor event (i.e. LTQ_NL80211_VENDOR_EVENT_RADAR_DETECTED)
+ *  \param[in] bool isHighPriority - true: latency-critical; false: delivered along with the rest of the events
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ *  \note Regardless of the callback workers, the listener handles the driver's events ahead of the hostap events that are ready along
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_driver_nl_event_priority_set(int subevent, bool isHighPriority)
+{
+	if ( (subevent < 0) || (subevent >= 64) )
+	{
+		console_printf("%s; subevent (%d) is out of range (0..63) ==> Abort!\n", __FUNCTION__, subevent);
 		return DWPAL_FAILURE;
 	}
 
-	if (dwpal_hostap_cmd_send(context[idx], cmdHeader, fieldsToCmdParse, reply, replyLen) == DWPAL_FAILURE)
+	console_printf("%s; subevent= %d, isHighPriority= %d\n", __FUNCTION__, subevent, isHighPriority);
+
+	if (isListenerThread())
 	{
-		console_printf("%s; '%s' command send error\n", __FUNCTION__, cmdHeader);
-		*replyLen = 0;
-		pthread_mutex_unlock(&context_mutex);
+		console_printf("%s; called from an event callback (subevent= %d) ==> Abort!\n", __FUNCTION__, subevent);
 		return DWPAL_FAILURE;
 	}
-	pthread_mutex_unlock(&context_mutex);
 
-	if (strncmp(cmdHeader, "PING", sizeof("PING")))
+	pthread_rwlock_wrlock(&services_lock);
+
+	if (isHighPriority)
 	{
-		cli_printf("%s; replyLen= %d\nreply=\n%s\n", __FUNCTION__, *replyLen, reply);
+		highPriorityNlEvents |= (1ULL << subevent);
 	}
 	else
 	{
-		console_printf("%s; replyLen= %d\nreply=\n%s\n", __FUNCTION__, *replyLen, reply);
+		highPriorityNlEvents &= ~(1ULL << subevent);
 	}
 
+	pthread_rwlock_unlock(&services_lock);
+
 	return DWPAL_SUCCESS;
 }
 
 
 /**************************************************************************/
-/*! \fn DWPAL_Ret dwpal_ext_hostap_interface_detach(char *VAPName)
+/*! \fn DWPAL_Ret dwpal_ext_hostap_event_queue_set(char *VAPName, unsigned int maxQueued, DwpalExtEventQueuePolicy policy)
  **************************************************************************
- *  \brief Will reset and detach the interface towards/from the hostapd/supplicant of the requested radio/VAP interface
- *  \param[in] char *VAPName - The interface's radio/VAP name to detach from
+ *  \brief Bound the events of an attached interface, that are queued to its callback worker (see dwpal_ext_callback_workers_set) and
+ *         not delivered yet; once the bound is reached, the policy tells which event is dropped.
+ *         The queued events are counted, per interface and per op-code (see dwpal_ext_hostap_event_queue_stats_get)
+ *  \param[in] char *VAPName - The interface's radio/VAP name
+ *  \param[in] unsigned int maxQueued - The maximal number of queued events; 0 for no bound, but the worker's queue (that is shared by
+ *             the interfaces of the worker)
+ *  \param[in] DwpalExtEventQueuePolicy policy - DWPAL_EXT_EVENT_QUEUE_DROP_NEWEST, DWPAL_EXT_EVENT_QUEUE_DROP_OLDEST or
+ *             DWPAL_EXT_EVENT_QUEUE_COALESCE
  *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ *  \note The latency-critical events (see dwpal_ext_hostap_event_priority_set) are neither bounded nor dropped for it.
+ *        The dropped events of DROP_OLDEST and COALESCE are skipped by the worker, and hold their worker queue slots till then; once
+ *        as many as maxQueued of them are waiting to be skipped, the newest event is dropped instead. DROP_OLDEST counts them as queued
+ *        for their op-code till skipped. highWaterMark never exceeds maxQueued.
+ *        Without callback workers, the events are not queued by the library at all; the backlog is left in the event socket
+ *        (see numOfOverflows of dwpal_ext_hostap_event_stats_get). The bound is reset by the interface detach
  ***************************************************************************/
-DWPAL_Ret dwpal_ext_hostap_interface_detach(char *VAPName)
+DWPAL_Ret dwpal_ext_hostap_event_queue_set(char *VAPName, unsigned int maxQueued, DwpalExtEventQueuePolicy policy)
 {
-	int  idx;
-	DWPAL_Ret ret;
+	int       idx;
+	DWPAL_Ret ret = DWPAL_SUCCESS;
 
-	if (VAPName == NULL)
+	if ( (VAPName == NULL) || (policy < DWPAL_EXT_EVENT_QUEUE_DROP_NEWEST) || (policy > DWPAL_EXT_EVENT_QUEUE_COALESCE) )
 	{
-		console_printf("%s; VAPName is NULL ==> Abort!\n", __FUNCTION__);
+		console_printf("%s; input params error ==> Abort!\n", __FUNCTION__);
 		return DWPAL_FAILURE;
 	}
 
-	console_printf("%s Entry; VAPName= '%s'\n", __FUNCTION__, VAPName);
+	console_printf("%s; VAPName= '%s', maxQueued= %u, policy= %d\n", __FUNCTION__, VAPName, maxQueued, policy);
 
-	pthread_mutex_lock(&attach_mutex);
+	if (isListenerThread())
+	{
+		console_printf("%s; called from an event callback (VAPName= '%s') ==> Abort!\n", __FUNCTION__, VAPName);
+		return DWPAL_FAILURE;
+	}
 
-	if ((ret = interfaceIndexGet("hostap", VAPName, &idx)) == DWPAL_INTERFACE_IS_DOWN)
+	pthread_rwlock_wrlock(&services_lock);
+
+	if (interfaceIndexGet("hostap", VAPName, &idx) != DWPAL_SUCCESS)
 	{
 		console_printf("%s; interfaceIndexGet (VAPName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
-		goto end;
+		ret = DWPAL_FAILURE;
+	}
+	else
+	{
+		dwpalService[idx]->queueBound.maxQueued = maxQueued;
+		dwpalService[idx]->queueBound.policy = policy;
 	}
 
-	console_printf("%s; interfaceIndexGet returned idx= %d\n", __FUNCTION__, idx);
+	pthread_rwlock_unlock(&services_lock);
 
-#if defined EVENT_CALLBACK_THREAD
-	threadSet(&eventHandlerThreadId, THREAD_CANCEL, NULL);
-#endif
-	/* Cancel the listener thread, if it does exist */
-	threadSet(&listenerThreadId, THREAD_CANCEL, NULL);
+	return ret;
+}
 
-	/* dealocate the interface (after canceling the listener thread) */
-	if (dwpalService[idx] != NULL)
+
+/**************************************************************************/
+/*! \fn DWPAL_Ret dwpal_ext_hostap_event_queue_stats_get(char *VAPName, char *opCode, DwpalExtEventQueueStats *stats)
+ **************************************************************************
+ *  \brief Get the counters of the events that an attached interface queued to its callback worker (see dwpal_ext_hostap_event_queue_set)
+ *  \param[in] char *VAPName - The interface's radio/VAP name
+ *  \param[in] char *opCode - The op-code to get the counters of; NULL for the counters of all the op-codes
+ *  \param[out] DwpalExtEventQueueStats *stats - The counters, since the interface was attached; all 0 for an op-code never queued
+ *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ *  \note The counters are kept for the first 32 op-codes of each interface; the rest are counted for the interface only
+ ***************************************************************************/
+DWPAL_Ret dwpal_ext_hostap_event_queue_stats_get(char *VAPName, char *opCode, DwpalExtEventQueueStats *stats /*OUT*/)
+{
+	int                     idx, i, numOfOpCodeStats;
+	DwpalExtEventQueueStats *counters = NULL;
+	DWPAL_Ret               ret = DWPAL_SUCCESS;
+
+	if ( (VAPName == NULL) || (stats == NULL) )
 	{
-		free((void *)dwpalService[idx]);
-		dwpalService[idx] = NULL;
+		console_printf("%s; VAPName/stats is NULL ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
 	}
 
-	if (context[idx] != NULL && dwpal_hostap_interface_detach(&context[idx]) == DWPAL_FAILURE)
+	memset(stats, 0, sizeof(*stats));
+
+	pthread_rwlock_rdlock(&services_lock);
+
+	if (interfaceIndexGet("hostap", VAPName, &idx) != DWPAL_SUCCESS)
 	{
-		console_printf("%s; dwpal_hostap_interface_detach (VAPName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
+		console_printf("%s; interfaceIndexGet (VAPName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
 		ret = DWPAL_FAILURE;
-		goto end;
 	}
-
-	ret = DWPAL_SUCCESS;
-end:
-	if (isAnyInterfaceActive())
-	{ /* There are still active interfaces */
-#if defined EVENT_CALLBACK_THREAD
-		threadSet(&eventHandlerThreadId, THREAD_CREATE, eventHandlerThreadStart);
-#endif
-		/* Create the listener thread, if it does exist */
-		threadSet(&listenerThreadId, THREAD_CREATE, listenerThreadStart);
+	else if (opCode == NULL)
+	{
+		counters = &dwpalService[idx]->queueBound.stats;
 	}
-#if defined EVENT_CALLBACK_THREAD
-	else if (dwpal_event_handler != (-1))
+	else
 	{
-		pid_t pid = getpid();
-		char  socketName[SOCKET_NAME_LENGTH] = "\0";
-
-		snprintf_s(socketName, sizeof(socketName), "%s_%d", EVENT_HANDLER_SOCKET, pid);
-
-		if (close(dwpal_event_handler) == (-1))
+		numOfOpCodeStats = __atomic_load_n(&dwpalService[idx]->queueBound.numOfOpCodeStats, __ATOMIC_ACQUIRE);
+		for (i=0; i < numOfOpCodeStats; i++)
 		{
-			console_printf("%s; close() fail; dwpal_event_handler= %d; errno= %d ('%s')\n", __FUNCTION__, dwpal_event_handler, errno, strerror(errno));
+			if (!strncmp(dwpalService[idx]->queueBound.opCodeStats[i].opCode, opCode, DWPAL_OPCODE_STRING_LENGTH))
+			{
+				counters = &dwpalService[idx]->queueBound.opCodeStats[i].stats;
+				break;
+			}
 		}
+	}
 
-		unlink(socketName);
-		dwpal_event_handler = (-1);
+	if (counters != NULL)
+	{
+		stats->numOfQueued = __atomic_load_n(&counters->numOfQueued, __ATOMIC_RELAXED);
+		stats->highWaterMark = __atomic_load_n(&counters->highWaterMark, __ATOMIC_RELAXED);
+		stats->numOfDropped = __atomic_load_n(&counters->numOfDropped, __ATOMIC_RELAXED);
 	}
-#endif
 
-	pthread_mutex_unlock(&attach_mutex);
+	pthread_rwlock_unlock(&services_lock);
+
 	return ret;
 }
 
 
 /**************************************************************************/
-/*! \fn DWPAL_Ret dwpal_ext_hostap_interface_attach(char *VAPName, DwpalExtHostapEventCallback hostapEventCallback)
+/*! \fn DWPAL_Ret dwpal_ext_thread_attr_set(DwpalExtThreadType threadType, DwpalExtThreadAttr *newThreadAttr)
  **************************************************************************
- *  \brief Hostapd/supplicant interface attach and event callback register
- *  \param[in] char *VAPName - The interface's radio/vap name to set attachment to
- *  \param[in] DwpalExtHostapEventCallback hostapEventCallback - The callback function to be called when an event will be received via this interface
+ *  \brief Set the attributes of the library's threads: the stack size, the CPU affinity, the scheduling and the name; i.e. for pinning
+ *         the event handling to a dedicated core. Running threads (of both types) are restarted with the new attributes
+ *  \param[in] DwpalExtThreadType threadType - DWPAL_EXT_THREAD_LISTENER or DWPAL_EXT_THREAD_CALLBACK_WORKER (all the workers)
+ *  \param[in] DwpalExtThreadAttr *newThreadAttr - The attributes; stackSize is either 0 or at least PTHREAD_STACK_MIN
  *  \return DWPAL_Ret (DWPAL_SUCCESS for success, other for failure)
+ *  \note A real-time scheduling (SCHED_FIFO/SCHED_RR) needs the CAP_SYS_NICE capability; without it, the threads are created with the
+ *        default scheduling. In case of dwpal_ext_external_loop_set, the listener's work is done by the caller's thread, whose
+ *        attributes are up to the caller
  ***************************************************************************/
-DWPAL_Ret dwpal_ext_hostap_interface_attach(char *VAPName, DwpalExtHostapEventCallback hostapEventCallback)
+DWPAL_Ret dwpal_ext_thread_attr_set(DwpalExtThreadType threadType, DwpalExtThreadAttr *newThreadAttr)
 {
-	int       idx;
-	DWPAL_Ret ret;
-
-	if (VAPName == NULL)
-	{
-		console_printf("%s; VAPName is NULL ==> Abort!\n", __FUNCTION__);
-		return DWPAL_FAILURE;
-	}
-
-	if (hostapEventCallback == NULL)
+	if ( (threadType < DWPAL_EXT_THREAD_LISTENER) || (threadType >= DWPAL_EXT_NUM_OF_THREAD_TYPES) || (newThreadAttr == NULL) )
 	{
-		console_printf("%s; hostapEventCallback is NULL ==> Abort!\n", __FUNCTION__);
+		console_printf("%s; input params error ==> Abort!\n", __FUNCTION__);
 		return DWPAL_FAILURE;
 	}
 
-	console_printf("%s Entry; VAPName= '%s'\n", __FUNCTION__, VAPName);
-
-	pthread_mutex_lock(&attach_mutex);
+	console_printf("%s; threadType= %d, stackSize= %d, cpuMask= 0x%llx, schedPolicy= %d, schedPriority= %d\n", __FUNCTION__, threadType,
+	               (int)newThreadAttr->stackSize, (unsigned long long)newThreadAttr->cpuMask, newThreadAttr->schedPolicy, newThreadAttr->schedPriority);
 
-	ret = interfaceIndexCreate("hostap", VAPName, &idx);
-	if (ret == DWPAL_FAILURE)
-	{
-		console_printf("%s; interfaceIndexCreate (VAPName= '%s') returned ERROR ==> Abort!\n", __FUNCTION__, VAPName);
-		goto end;
-	}
-	else if (ret == DWPAL_INTERFACE_ALREADY_UP)
+	if ( (newThreadAttr->stackSize > 0) && (newThreadAttr->stackSize < (size_t)PTHREAD_STACK_MIN) )
 	{
-		console_printf("%s; Interface (idx= %d) is already up ==> cont...\n", __FUNCTION__, idx);
-		ret = DWPAL_SUCCESS;
-		goto end;
+		console_printf("%s; stackSize (%d) is below PTHREAD_STACK_MIN (%d) ==> Abort!\n", __FUNCTION__, (int)newThreadAttr->stackSize, (int)PTHREAD_STACK_MIN);
+		return DWPAL_FAILURE;
 	}
 
-	console_printf("%s; interfaceIndexCreate successfully; returned idx= %d\n", __FUNCTION__, idx);
-
-#if defined EVENT_CALLBACK_THREAD
-	if (dwpal_event_handler == -1)
+	if ( (newThreadAttr->schedPolicy == SCHED_FIFO) || (newThreadAttr->schedPolicy == SCHED_RR) )
 	{
-		if (dwpal_socket_create(&dwpal_event_handler /*output*/, EVENT_HANDLER_SOCKET) == DWPAL_FAILURE)
+		if ( (newThreadAttr->schedPriority < sched_get_priority_min(newThreadAttr->schedPolicy)) ||
+		     (newThreadAttr->schedPriority > sched_get_priority_max(newThreadAttr->schedPolicy)) )
 		{
-			console_printf("%s; dwpal_socket_create returned ERROR ==> Abort!\n", __FUNCTION__);
-			ret = DWPAL_FAILURE;
-			goto end;
+			console_printf("%s; schedPriority (%d) out of range ==> Abort!\n", __FUNCTION__, newThreadAttr->schedPriority);
+			return DWPAL_FAILURE;
 		}
 	}
-#endif
-
-	/* Cancel the listener thread, if it does exist */
-#if defined EVENT_CALLBACK_THREAD
-	threadSet(&eventHandlerThreadId, THREAD_CANCEL, NULL);
-#endif
-	threadSet(&listenerThreadId, THREAD_CANCEL, NULL);
-
-	ret = DWPAL_SUCCESS;
-	if (dwpal_hostap_interface_attach(&context[idx] /*OUT*/, VAPName, NULL /*use one-way interface*/) != DWPAL_SUCCESS)
+	else if (newThreadAttr->schedPolicy != SCHED_OTHER)
 	{
-		console_printf("%s; dwpal_hostap_interface_attach (VAPName= '%s') returned ERROR ==> try later on...\n", __FUNCTION__, VAPName);
-
-		/* in this case, continue and try to establish the connection later on */
-		dwpalService[idx]->isConnectionEstablishNeeded = true;
-		ret = DWPAL_INTERFACE_IS_DOWN;
+		console_printf("%s; schedPolicy (%d) not supported ==> Abort!\n", __FUNCTION__, newThreadAttr->schedPolicy);
+		return DWPAL_FAILURE;
 	}
 
-	/* Set the callback whether attach succeeded or not */
-	dwpalService[idx]->hostapEventCallback = hostapEventCallback;
-
-	if (ret == DWPAL_SUCCESS)
+	if (isListenerThread())
 	{
-		dwpalService[idx]->isConnectionEstablishNeeded = false;
+		console_printf("%s; called from an event callback ==> Abort!\n", __FUNCTION__);
+		return DWPAL_FAILURE;
 	}
 
+	pthread_mutex_lock(&attach_mutex);
+
+	threadAttr[threadType] = *newThreadAttr;
+	threadAttr[threadType].name[sizeof(threadAttr[threadType].name) - 1] = '\0';
 
-end:
-	if (ret == DWPAL_FAILURE && dwpalService[idx] != NULL)
+	if (isExternalLoop)
 	{
-		free((void *)dwpalService[idx]);
-		dwpalService[idx] = NULL;
+		if (threadType == DWPAL_EXT_THREAD_CALLBACK_WORKER)
+		{  /* no listener round (the workers' producer) runs meanwhile */
+			pthread_mutex_lock(&dispatch_mutex);
+			callbackWorkersStop();
+			callbackWorkersStart();
+			pthread_mutex_unlock(&dispatch_mutex);
+		}
 	}
-
-	/* Create the listener thread, if it does NOT exist yet */
-	if (isAnyInterfaceActive())
+	else if ( (listenerThreadId != 0) && ((threadType == DWPAL_EXT_THREAD_LISTENER) || (numOfCallbackWorkers > 0)) )
 	{
-#if defined EVENT_CALLBACK_THREAD
-		threadSet(&eventHandlerThreadId, THREAD_CREATE, eventHandlerThreadStart);
-#endif
-		threadSet(&listenerThreadId, THREAD_CREATE, listenerThreadStart);
+		/* The listener thread (the workers' producer) is stopped first, and both are re-created with the new attributes */
+		threadSet(&listenerThreadId, THREAD_CANCEL, NULL);
+		callbackWorkersStop();
+		listenerThreadsUpdate();
 	}
 
 	pthread_mutex_unlock(&attach_mutex);
-	return ret;
+	return DWPAL_SUCCESS;
 }
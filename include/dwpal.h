@@ -38,6 +38,7 @@
 #define NUM_OF_SSIDS                           16
 #define SSID_STRING_LENGTH                     32
 #define MAX_FILE_NAME                          256
+#define DWPAL_HOSTAPD_CMD_TIMEOUT_MS           10000  /* default deadline of a hostapd command round trip */
 #define SCAN_FINISH_CB 0 // user defined callback to identify last callback of scan dump result
 #define console_printf(...)     \
 {                               \
@@ -54,7 +55,8 @@ typedef enum
 	DWPAL_NO_PENDING_MESSAGES,		/**< DWPAL_NO_PENDING_MESSAGES 		 */
 	DWPAL_MISSING_PARAM,			/**< DWPAL_MISSING_PARAM 		 	 */
 	DWPAL_INTERFACE_IS_DOWN,		/**< DWPAL_INTERFACE_IS_DOWN 	 	 */
-	DWPAL_INTERFACE_ALREADY_UP		/**< DWPAL_INTERFACE_ALREADY_UP 	 	 */
+	DWPAL_INTERFACE_ALREADY_UP,		/**< DWPAL_INTERFACE_ALREADY_UP 	 	 */
+	DWPAL_TIMEOUT					/**< DWPAL_TIMEOUT 				 	 */
 } DWPAL_Ret;
 
 typedef enum
@@ -149,11 +151,24 @@ DWPAL_Ret dwpal_driver_nl_attach(void **context /*OUT*/);
 
 DWPAL_Ret dwpal_string_to_struct_parse(char *msg, size_t msgLen, FieldsToParse fieldsToParse[], size_t userBufLen);
 DWPAL_Ret dwpal_hostap_cmd_send(void *context, const char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char *reply /*OUT*/, size_t *replyLen /*IN/OUT*/);
+DWPAL_Ret dwpal_hostap_cmd_send_timeout(void *context, const char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char *reply /*OUT*/, size_t *replyLen /*IN/OUT*/, unsigned int timeoutMs);
+DWPAL_Ret dwpal_hostap_cmd_send_alloc(void *context, const char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char **reply /*OUT*/, size_t *replyLen /*OUT*/, unsigned int timeoutMs);
+DWPAL_Ret dwpal_hostap_cmd_timeout_set(void *context, unsigned int timeoutMs);
 DWPAL_Ret dwpal_hostap_event_get(void *context, char *msg /*OUT*/, size_t *msgLen /*IN/OUT*/, char *opCode /*OUT*/);
+DWPAL_Ret dwpal_hostap_event_len_get(void *context, size_t *msgLen /*OUT*/);
+DWPAL_Ret dwpal_hostap_event_opcode_peek(void *context, char *opCode /*OUT*/, size_t opCodeSize);
+DWPAL_Ret dwpal_hostap_event_discard(void *context);
+DWPAL_Ret dwpal_hostap_event_level_set(void *context, int level);
+DWPAL_Ret dwpal_hostap_event_reattach(void *context, bool *isDetached /*OUT*/);
+DWPAL_Ret dwpal_hostap_event_rcvbuf_set(void *context, int size);
 DWPAL_Ret dwpal_hostap_event_fd_get(void *context, int *fd /*OUT*/);
 DWPAL_Ret dwpal_hostap_socket_close(void **context);
 DWPAL_Ret dwpal_hostap_is_socket_alive(void *context, bool *isExist /*OUT*/);
+DWPAL_Ret dwpal_hostap_ping_send(void *context);
+DWPAL_Ret dwpal_hostap_liveness_get(void *context, unsigned int *idleMs /*OUT*/, unsigned int *pingPendingMs /*OUT*/);
 DWPAL_Ret dwpal_hostap_interface_detach(void **context /*IN/OUT*/);
+DWPAL_Ret dwpal_hostap_abstract_client_socket_set(bool isAbstract);
+DWPAL_Ret dwpal_hostap_interfaces_enumerate(char VAPNames[][DWPAL_VAP_NAME_STRING_LENGTH] /*OUT*/, size_t *numOfVAPs /*IN/OUT*/);
 DWPAL_Ret dwpal_hostap_interface_attach(void **context /*OUT*/, const char *VAPName, DWPAL_wpaCtrlEventCallback wpaCtrlEventCallback);
 
 #endif  //__DWPAL_H_
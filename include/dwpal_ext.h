@@ -9,6 +9,7 @@
 #define __DWPAL_EXT_H_
 
 
+#include <stdint.h>
 #include "dwpal.h"
 
 #define NUM_OF_SUPPORTED_VAPS 32
@@ -24,6 +25,48 @@ typedef int (*DwpalExtHostapEventCallback)(char *VAPName, char *opCode, char *ms
 typedef DWPAL_nlVendorEventCallback DwpalExtNlEventCallback;  /* DWPAL_Ret DWPAL_nlVendorEventCallback(size_t len, unsigned char *data); */
 typedef DWPAL_nlNonVendorEventCallback DwpalExtNlNonVendorEventCallback;
 
+typedef struct
+{
+	unsigned int numOfOverflows;        /* the event socket stayed full for several rounds; hostapd may have failed sending events */
+	unsigned int numOfDroppedEvents;    /* events received, but not delivered to the callback (i.e. out of memory) */
+	unsigned int numOfMonitorDetaches;  /* hostapd had stopped sending events (too many failed sends), and was re-attached */
+	unsigned int numOfResyncs;          /* "EVENTS_RESYNC_NEEDED" notifications */
+	unsigned int numOfSuppressedEvents; /* events coalesced or rate limited (see dwpal_ext_hostap_event_coalesce_set) */
+} DwpalExtHostapEventStats;
+
+/* What is dropped once an interface's events, that are queued to its callback worker, reached their bound */
+typedef enum
+{
+	DWPAL_EXT_EVENT_QUEUE_DROP_NEWEST = 0,  /* the new event */
+	DWPAL_EXT_EVENT_QUEUE_DROP_OLDEST,      /* the oldest queued event of the interface */
+	DWPAL_EXT_EVENT_QUEUE_COALESCE          /* the queued events of the same op-code, that the new event replaces */
+} DwpalExtEventQueuePolicy;
+
+typedef enum
+{
+	DWPAL_EXT_THREAD_LISTENER = 0,     /* the listener thread */
+	DWPAL_EXT_THREAD_CALLBACK_WORKER,  /* the callback workers (see dwpal_ext_callback_workers_set) */
+
+	/* Must be at the end */
+	DWPAL_EXT_NUM_OF_THREAD_TYPES
+} DwpalExtThreadType;
+
+typedef struct
+{
+	size_t   stackSize;      /* 0 for the system default */
+	uint64_t cpuMask;        /* the CPUs (bit per CPU, of the first 64) the thread may run on; 0 for all */
+	int      schedPolicy;    /* SCHED_OTHER, SCHED_FIFO or SCHED_RR */
+	int      schedPriority;  /* SCHED_FIFO/SCHED_RR only: 1..99 */
+	char     name[16];       /* "dwpal_listener"/"dwpal_worker" by default; the workers' names are suffixed by their number; empty for none */
+} DwpalExtThreadAttr;
+
+typedef struct
+{
+	unsigned int numOfQueued;    /* events queued to the callback worker, and not delivered yet */
+	unsigned int highWaterMark;  /* the maximal numOfQueued */
+	unsigned int numOfDropped;   /* events dropped by the bound, or by a full worker queue */
+} DwpalExtEventQueueStats;
+
 
 /* APIs */
 DWPAL_Ret dwpal_ext_driver_nl_scan_dump(char *ifname, DWPAL_nlNonVendorEventCallback nlEventCallback);
@@ -34,7 +77,30 @@ DWPAL_Ret dwpal_ext_driver_nl_detach(void);
 DWPAL_Ret dwpal_ext_driver_nl_attach(DwpalExtNlEventCallback nlEventCallback, DwpalExtNlNonVendorEventCallback nlNonVendorEventCallback);
 
 DWPAL_Ret dwpal_ext_hostap_cmd_send(char *VAPName, char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char *reply /*OUT*/, size_t *replyLen /*IN/OUT*/);
+DWPAL_Ret dwpal_ext_hostap_cmd_send_timeout(char *VAPName, char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char *reply /*OUT*/, size_t *replyLen /*IN/OUT*/, unsigned int timeoutMs);
+DWPAL_Ret dwpal_ext_hostap_cmd_send_alloc(char *VAPName, char *cmdHeader, FieldsToCmdParse *fieldsToCmdParse, char **reply /*OUT*/, size_t *replyLen /*OUT*/);
+DWPAL_Ret dwpal_ext_hostap_cmd_timeout_set(unsigned int timeoutMs);
+DWPAL_Ret dwpal_ext_hostap_cmd_cache_set(char *cmdName, unsigned int ttlMs);
+DWPAL_Ret dwpal_ext_hostap_cmd_cache_flush(char *VAPName);
+DWPAL_Ret dwpal_ext_hostap_two_way_set(bool isTwoWay);
 DWPAL_Ret dwpal_ext_hostap_interface_detach(char *VAPName);
 DWPAL_Ret dwpal_ext_hostap_interface_attach(char *VAPName, DwpalExtHostapEventCallback eventCallback);
+DWPAL_Ret dwpal_ext_hostap_interfaces_attach(char *VAPNames[], size_t numOfVAPs, DwpalExtHostapEventCallback eventCallback);
+DWPAL_Ret dwpal_ext_hostap_event_subscribe(char *VAPName, char *opCodes[], size_t numOfOpCodes, int minLevel);
+DWPAL_Ret dwpal_ext_hostap_event_rcvbuf_set(int size);
+DWPAL_Ret dwpal_ext_hostap_event_stats_get(char *VAPName, DwpalExtHostapEventStats *stats /*OUT*/);
+DWPAL_Ret dwpal_ext_hostap_state_track_set(char *VAPName, bool isEnabled);
+DWPAL_Ret dwpal_ext_hostap_event_coalesce_set(char *opCode, unsigned int windowMs, unsigned int maxPerSec);
+DWPAL_Ret dwpal_ext_hostap_event_suppressed_get(char *VAPName, char *opCode, unsigned int *numOfSuppressed /*OUT*/);
+DWPAL_Ret dwpal_ext_hostap_event_priority_set(char *opCode, bool isHighPriority);
+DWPAL_Ret dwpal_ext_driver_nl_event_priority_set(int subevent, bool isHighPriority);
+DWPAL_Ret dwpal_ext_hostap_event_queue_set(char *VAPName, unsigned int maxQueued, DwpalExtEventQueuePolicy policy);
+DWPAL_Ret dwpal_ext_hostap_event_queue_stats_get(char *VAPName, char *opCode, DwpalExtEventQueueStats *stats /*OUT*/);
+DWPAL_Ret dwpal_ext_thread_attr_set(DwpalExtThreadType threadType, DwpalExtThreadAttr *newThreadAttr);
+
+DWPAL_Ret dwpal_ext_callback_workers_set(int numOfWorkers);
+DWPAL_Ret dwpal_ext_external_loop_set(bool isEnabled);
+DWPAL_Ret dwpal_ext_fd_get(int *fd /*OUT*/);
+DWPAL_Ret dwpal_ext_dispatch(int timeoutMs);
 
 #endif  //__DWPAL_EXT_H_
@@ -7,6 +7,7 @@
  */
 
 #include "includes.h"
+#include <poll.h>
 
 #ifdef CONFIG_CTRL_IFACE
 
@@ -114,6 +115,20 @@ struct wpa_ctrl * wpa_ctrl_open2(const char *ctrl_path,
 
 	ctrl->local.sun_family = AF_UNIX;
 	counter++;
+	if (cli_path && os_strcmp(cli_path, "@abstract") == 0) {
+		/*
+		 * Let the kernel bind the client socket to a unique name in
+		 * the abstract namespace (Linux autobind); there is no file to
+		 * create, clean up, or collide with.
+		 */
+		if (bind(ctrl->s, (struct sockaddr *) &ctrl->local,
+			 sizeof(sa_family_t)) < 0) {
+			close(ctrl->s);
+			os_free(ctrl);
+			return NULL;
+		}
+		goto bound;
+	}
 try_again:
 	if (cli_path && cli_path[0] == '/') {
 		ret = os_snprintf(ctrl->local.sun_path,
@@ -150,6 +165,7 @@ try_again:
 		return NULL;
 	}
 
+bound:
 #ifdef ANDROID
 	chmod(ctrl->local.sun_path, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
 	/* Set group even if we do not have privileges to change owner */
@@ -234,7 +250,8 @@ void wpa_ctrl_close(struct wpa_ctrl *ctrl)
 {
 	if (ctrl == NULL)
 		return;
-	unlink(ctrl->local.sun_path);
+	if (ctrl->local.sun_path[0] != '\0') /* not in the abstract namespace */
+		unlink(ctrl->local.sun_path);
 	if (ctrl->s >= 0)
 		close(ctrl->s);
 	os_free(ctrl);
@@ -508,16 +525,23 @@ retry_send:
 			 * Must be a non-blocking socket... Try for a bit
 			 * longer before giving up.
 			 */
-			if (started_at.sec == 0)
+			struct os_reltime n, age;
+			struct pollfd pfd;
+
+			if (started_at.sec == 0 && started_at.usec == 0)
 				os_get_reltime(&started_at);
-			else {
-				struct os_reltime n;
-				os_get_reltime(&n);
-				/* Try for a few seconds. */
-				if (os_reltime_expired(&n, &started_at, 5))
-					goto send_err;
-			}
-			os_sleep(1, 0);
+			os_get_reltime(&n);
+			/* Try for a few seconds. */
+			if (os_reltime_expired(&n, &started_at, 5))
+				goto send_err;
+			os_reltime_sub(&n, &started_at, &age);
+
+			/* Wait for room in the socket instead of sleeping */
+			pfd.fd = ctrl->s;
+			pfd.events = POLLOUT;
+			if (poll(&pfd, 1, 5000 - (age.sec * 1000 + age.usec / 1000)) < 0 &&
+			    errno != EINTR && errno != EAGAIN)
+				goto send_err;
 			goto retry_send;
 		}
 	send_err: